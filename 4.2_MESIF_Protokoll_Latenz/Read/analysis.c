@@ -0,0 +1,195 @@
+/********************************************************************
+ * BenchIT - Performance Measurement for Scientific Applications
+ * Contact: developer@benchit.org
+ *
+ * $Id$
+ * For license details see COPYING in the package base directory
+ *******************************************************************/
+/* Kernel: measures read latency of data located in different cache levels or memory of certain CPUs.
+ * change point detection on the latency curves (BENCHIT_KERNEL_PLATEAU_ANALYSIS)
+ * DRAM bank function search (BENCHIT_KERNEL_DRAM_SOLVE)
+ *******************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "analysis.h"
+
+/* lower limit for the noise estimation in log space (1%), the latencies are integer cycles and often identical on a plateau */
+#define MIN_SIGMA 0.01
+
+/* 97.5% quantiles of the t-distribution for 1 to 30 degrees of freedom */
+static const double t_quantile[30]={12.706,4.303,3.182,2.776,2.571,2.447,2.365,2.306,2.262,2.228,
+                                    2.201,2.179,2.160,2.145,2.131,2.120,2.110,2.101,2.093,2.086,
+                                    2.080,2.074,2.069,2.064,2.060,2.056,2.052,2.048,2.045,2.042};
+
+typedef struct point
+{
+   double size;
+   double latency;
+} point_t;
+
+static int compare_points(const void *a, const void *b)
+{
+  if (((point_t*)a)->size<((point_t*)b)->size) return -1;
+  if (((point_t*)a)->size>((point_t*)b)->size) return 1;
+  return 0;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+  if (*((double*)a)<*((double*)b)) return -1;
+  if (*((double*)a)>*((double*)b)) return 1;
+  return 0;
+}
+
+int find_plateaus(const double *sizes, const double *latencies, int n, int min_points, plateau_t *plateaus)
+{
+  point_t *points;
+  double *sum,*sum_sq,*cost,*diff,sigma,penalty,mean,var,c;
+  int *last,i,j,k,m,num_segments;
+
+  if (min_points<1) min_points=1;
+  points=(point_t*)malloc(n*sizeof(point_t));
+  sum=(double*)malloc((n+1)*sizeof(double));
+  sum_sq=(double*)malloc((n+1)*sizeof(double));
+  cost=(double*)malloc((n+1)*sizeof(double));
+  diff=(double*)malloc((n+1)*sizeof(double));
+  last=(int*)malloc((n+1)*sizeof(int));
+  num_segments=0;
+  m=0;
+  if ((points!=NULL)&&(sum!=NULL)&&(sum_sq!=NULL)&&(cost!=NULL)&&(diff!=NULL)&&(last!=NULL)){
+    for (i=0;i<n;i++) if (latencies[i]>0) {points[m].size=sizes[i];points[m].latency=latencies[i];m++;}
+  }
+  if (m==0){
+    free(points);free(sum);free(sum_sq);free(cost);free(diff);free(last);
+    return 0;
+  }
+  qsort(points,m,sizeof(point_t),compare_points);
+
+  /* the noise grows with the latency, so the model is fitted to log(latency) */
+  sum[0]=0;sum_sq[0]=0;
+  for (i=0;i<m;i++){
+    sum[i+1]=sum[i]+log(points[i].latency);
+    sum_sq[i+1]=sum_sq[i]+log(points[i].latency)*log(points[i].latency);
+  }
+
+  /* robust noise estimation from the differences of neighbouring points, the few steps do not affect the median */
+  for (i=0;i<m-1;i++) diff[i]=fabs(log(points[i+1].latency)-log(points[i].latency));
+  sigma=0;
+  if (m>1){
+    qsort(diff,m-1,sizeof(double),compare_doubles);
+    sigma=1.4826*diff[(m-1)/2]/sqrt(2.0);
+  }
+  if (sigma<MIN_SIGMA) sigma=MIN_SIGMA;
+  penalty=2*sigma*sigma*log((double)m+1);
+
+  /* optimal partitioning: cost[j] is the minimal cost of the first j points, last[j] the start of the last segment */
+  cost[0]=-penalty;last[0]=0;
+  for (j=1;j<=m;j++){
+    cost[j]=HUGE_VAL;last[j]=0;
+    for (i=0;i<=j-min_points;i++){
+      if (cost[i]==HUGE_VAL) continue;
+      /* sum of squared errors of points i..j-1 */
+      c=sum_sq[j]-sum_sq[i]-(sum[j]-sum[i])*(sum[j]-sum[i])/(j-i);
+      if (c<0) c=0;
+      c+=cost[i]+penalty;
+      if (c<cost[j]) {cost[j]=c;last[j]=i;}
+    }
+  }
+  /* less than min_points measurements */
+  if (cost[m]==HUGE_VAL) last[m]=0;
+
+  /* backtracking, the segments are collected in reverse order */
+  j=m;
+  while (j>0){
+    i=last[j];
+    mean=0;var=0;
+    for (k=i;k<j;k++) mean+=points[k].latency;
+    mean/=(j-i);
+    for (k=i;k<j;k++) var+=(points[k].latency-mean)*(points[k].latency-mean);
+    if (j-i>1) var/=(j-i-1);
+    plateaus[num_segments].first_size=points[i].size;
+    plateaus[num_segments].last_size=points[j-1].size;
+    plateaus[num_segments].latency=mean;
+    plateaus[num_segments].points=j-i;
+    if (j-i<2) plateaus[num_segments].ci=0;
+    else if (j-i<=31) plateaus[num_segments].ci=t_quantile[j-i-2]*sqrt(var/(j-i));
+    else plateaus[num_segments].ci=1.96*sqrt(var/(j-i));
+    plateaus[num_segments].capacity=0;
+    if (j<m) plateaus[num_segments].capacity=sqrt(points[j-1].size*points[j].size);
+    plateaus[num_segments].flat=(sqrt(var)<0.1*mean);
+    num_segments++;
+    j=i;
+  }
+  for (i=0;i<num_segments/2;i++){
+    plateau_t tmp=plateaus[i];
+    plateaus[i]=plateaus[num_segments-1-i];
+    plateaus[num_segments-1-i]=tmp;
+  }
+
+  free(points);free(sum);free(sum_sq);free(cost);free(diff);free(last);
+  return num_segments;
+}
+
+/** checks if the parity of (address & mask) is constant within each group and differs between groups */
+static int is_group_function(const unsigned long long *addrs, const int *groups, int n, unsigned long long mask, int *values, int num_groups)
+{
+  int i,v,varies=0,first=-1;
+
+  for (i=0;i<num_groups;i++) values[i]=-1;
+  for (i=0;i<n;i++){
+    if (groups[i]<0) continue;
+    v=__builtin_parityll(addrs[i]&mask);
+    if (values[groups[i]]==-1){
+      values[groups[i]]=v;
+      if (first==-1) first=v;
+      else if (v!=first) varies=1;
+    }
+    else if (values[groups[i]]!=v) return 0;
+  }
+  return varies;
+}
+
+int find_xor_functions(const unsigned long long *addrs, const int *groups, int n, int min_bit, int max_bit, int max_weight, unsigned long long *functions, int max_functions)
+{
+  unsigned long long basis[64],mask,reduced;
+  int bits[64],*values,i,w,num_groups=0,num_functions=0,pivot;
+
+  if ((min_bit<0)||(max_bit>63)||(min_bit>max_bit)||(max_weight<1)) return 0;
+  for (i=0;i<n;i++) if (groups[i]+1>num_groups) num_groups=groups[i]+1;
+  values=(int*)malloc((num_groups+1)*sizeof(int));
+  if (values==NULL) return 0;
+  memset(basis,0,sizeof(basis));
+
+  /* all combinations of w bits, in order of increasing weight */
+  for (w=1;(w<=max_weight)&&(w<=max_bit-min_bit+1)&&(num_functions<max_functions);w++){
+    for (i=0;i<w;i++) bits[i]=min_bit+i;
+    while (num_functions<max_functions){
+      mask=0;
+      for (i=0;i<w;i++) mask|=1ULL<<bits[i];
+      if (is_group_function(addrs,groups,n,mask,values,num_groups)){
+        /* Gaussian elimination, basis[p] has its highest bit at p */
+        reduced=mask;
+        for (pivot=63;pivot>=0;pivot--) if ((reduced>>pivot)&1){
+          if (basis[pivot]) reduced^=basis[pivot];
+          else break;
+        }
+        if (reduced){
+          basis[pivot]=reduced;
+          functions[num_functions++]=mask;
+        }
+      }
+      /* next combination */
+      i=w-1;
+      while ((i>=0)&&(bits[i]==max_bit-(w-1-i))) i--;
+      if (i<0) break;
+      bits[i]++;
+      for (i++;i<w;i++) bits[i]=bits[i-1]+1;
+    }
+  }
+
+  free(values);
+  return num_functions;
+}
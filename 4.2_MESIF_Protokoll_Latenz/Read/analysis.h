@@ -0,0 +1,43 @@
+/********************************************************************
+ * BenchIT - Performance Measurement for Scientific Applications
+ * Contact: developer@benchit.org
+ *
+ * $Id$
+ * For license details see COPYING in the package base directory
+ *******************************************************************/
+/* Kernel: measures read latency of data located in different cache levels or memory of certain CPUs.
+ *******************************************************************/
+
+#ifndef __ANALYSIS_H
+#define __ANALYSIS_H
+
+/* segment of a latency curve with constant latency (BENCHIT_KERNEL_PLATEAU_ANALYSIS) */
+typedef struct plateau
+{
+   double first_size;                   /* smallest data set size in the segment */
+   double last_size;                    /* largest data set size in the segment */
+   double latency;                      /* mean latency of the segment */
+   double ci;                           /* half width of the 95% confidence interval of the mean */
+   double capacity;                     /* boundary to the next segment (geometric mean of the adjacent sizes), 0 for the last segment */
+   int points;
+   int flat;                            /* 1 if the coefficient of variation is below 10%, 0 for transitions between cache levels */
+} plateau_t;
+
+/** fits a piecewise-constant model to the latencies (optimal partitioning of log(latency) with a BIC-like penalty)
+ *  - sizes do not need to be sorted, invalid latencies (<=0) are ignored
+ *  - each segment contains at least min_points measurements
+ *  - plateaus has to provide space for n segments
+ *  @return number of segments
+ */
+int find_plateaus(const double *sizes, const double *latencies, int n, int min_points, plateau_t *plateaus);
+
+/** searches XOR functions of physical address bits that are constant within each group of addresses
+ *  (DRAM bank functions, BENCHIT_KERNEL_DRAM_SOLVE)
+ *  - functions combine 1 to max_weight bits from min_bit to max_bit, functions that are constant for all groups are ignored
+ *  - functions with fewer bits are preferred, only linearly independent functions (over GF(2)) are returned
+ *  - groups with negative ids are ignored
+ *  @return number of functions
+ */
+int find_xor_functions(const unsigned long long *addrs, const int *groups, int n, int min_bit, int max_bit, int max_weight, unsigned long long *functions, int max_functions);
+
+#endif
@@ -0,0 +1,286 @@
+/******************************************************************************************************
+ * BenchIT - Performance Measurement for Scientific Applications
+ * Contact: developer@benchit.org
+ *
+ * $Id$
+ * For license details see COPYING in the package base directory
+ ******************************************************************************************************/
+/* Kernel: measures read latency of data located in different cache levels or memory of certain CPUs.
+ ******************************************************************************************************/
+
+/*
+ * timed assembler kernels, compiled separately from the rest of the kernel with
+ * BENCHIT_CC_C_FLAGS_ASM (see COMPILE.SH), so that the optimization level of the
+ * harness does not change the measured code
+ */
+
+#include "work.h"
+
+#ifdef USE_PAPI
+#include <papi.h>
+#endif
+
+/* measure overhead of empty loop */
+int asm_loop_overhead(int n)
+{
+   unsigned long long a,b,c,d,i;
+   static unsigned long long ret=1000000;
+
+   for (i=0;i<n;i++){
+        /* Output: RAX: stop timestamp 
+         *         RBX: start timestamp
+         */
+       __asm__ __volatile__(
+                "mov $1,%%rcx;"       
+                TIMESTAMP
+                SERIALIZE
+                "mov %%rax,%%rbx;"
+//                "jmp _work_loop_overhead;"
+//                ".align 64,0x0;"
+//                "_work_loop_overhead:"
+//                "sub $1,%%rcx;"
+//                "jnz _work_loop_overhead;"
+                SERIALIZE    
+                TIMESTAMP
+                : "=a" (a), "=b" (b), "=c" (c), "=d" (d)
+        );
+        if ((a-b)<ret) ret=(a-b);
+   }			
+  return (int)ret;
+}
+
+/** assembler implementation of latency measurement using mov instruction
+ */
+int asm_work_mov(unsigned long long addr, unsigned long long passes,volatile mydata_t *data)
+{
+   if (!passes) return 0;
+   return (unsigned int) asm_work_mov_cycles(addr,passes,data)/(passes*24);
+}
+
+/** assembler implementation of latency measurement using mov instruction, returns the cycles of all accesses
+ *  (BENCHIT_KERNEL_STRUCTURE derives the latency per node from them without the truncation of asm_work_mov())
+ */
+unsigned long long asm_work_mov_cycles(unsigned long long addr, unsigned long long passes,volatile mydata_t *data)
+{
+   unsigned long long a,b=addr,c=passes;
+
+   if (!passes) return 0;
+
+   #ifdef USE_PAPI
+    if (data->num_events) PAPI_reset(data->Eventset);
+   #endif
+
+
+     /*
+      * Input:  RBX: addr (pointer to the buffer)
+      *         RCX: passes (number of loop iterations)
+      * Output: RAX: stop timestamp
+      *         RBX: start timestamp
+      */
+     __asm__ __volatile__(
+                TIMESTAMP
+                SERIALIZE
+/* standard version */
+                COMPUTE_INIT
+                "jmp _work_loop_mov_1;"
+                ".align 64,0x0;"
+                //loop that performs random memory accesses (memory contains precalculated random target addresses)
+                "_work_loop_mov_1:"
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)COMPUTE(COMPUTE_OPS)
+                "sub $1,%%rcx;"
+                "jnz _work_loop_mov_1;"
+
+                SERIALIZE
+                "mov %%rax,%%rbx;"
+                TIMESTAMP
+                : "=a" (a),"+b" (b),"+c" (c)
+                :
+                : "%rdx", "%r8", "%r9", "%r10", "%r11", "%r12", "%r13", "%r14", "%r15",
+                  "%xmm0", "%xmm1", "%xmm2", "%xmm3", "%xmm4", "%xmm5", "%xmm6", "%xmm7", "%xmm8", "%xmm9", "memory"
+
+     );
+  #ifdef USE_PAPI
+    if (data->num_events) PAPI_read(data->Eventset,data->values);
+  #endif
+    return (a-b)-data->cpuinfo->rdtsc_latency;
+}
+
+/** assembler implementation of instruction fetch latency measurement using a chain of jmp instructions
+ *  (BENCHIT_KERNEL_CODE_LATENCY), runs on all selected CPUs, so PAPI counters are not read
+ */
+int asm_work_jmp(unsigned long long addr, unsigned long long passes, unsigned long long jumps, volatile mydata_t *data)
+{
+   unsigned long long a,s,b=addr,c=passes;
+
+   if ((!passes)||(!jumps)) return 0;
+
+     /*
+      * Input:  RBX: addr (first jmp instruction of the chain)
+      *         RCX: passes (number of loop iterations)
+      * Output: RAX: stop timestamp
+      *         RSI: start timestamp
+      * the red zone below the stack pointer is skipped, as it could be used by this function
+      */
+     __asm__ __volatile__(
+                TIMESTAMP
+                SERIALIZE
+                "mov %%rax,%%rsi;"
+                "sub $128,%%rsp;"
+                "jmp _work_loop_jmp_1;"
+                ".align 64,0x0;"
+                "_work_loop_jmp_1:"
+                "call *%%rbx;"
+                "sub $1,%%rcx;"
+                "jnz _work_loop_jmp_1;"
+                "add $128,%%rsp;"
+                SERIALIZE
+                TIMESTAMP
+                : "=a" (a),"=S" (s),"+b" (b),"+c" (c)
+                :
+                : "%rdx", "memory"
+     );
+    return (unsigned int) ((a-s)-data->cpuinfo->rdtsc_latency)/(passes*jumps);
+}
+
+/** measures two independent loads of lines that are not cached (BENCHIT_KERNEL_DRAM_SOLVE)
+ *  both lines are flushed afterwards, the loads are serialized by the memory controller if the lines are located in
+ *  different rows of the same DRAM bank
+ *  @return cycles including the rdtsc latency
+ */
+unsigned long long asm_pair_latency(unsigned long long addr1, unsigned long long addr2)
+{
+   unsigned long long a;
+
+     /*
+      * Input:  RCX: addr1
+      *         RSI: addr2
+      * Output: RAX: duration
+      */
+     __asm__ __volatile__(
+                "mfence;"
+                TIMESTAMP
+                "mov %%rax,%%r8;"
+                "mov (%%rcx), %%r9;"
+                "mov (%%rsi), %%r10;"
+                "lfence;"
+                TIMESTAMP
+                "sub %%r8,%%rax;"
+                "clflush (%%rcx);"
+                "clflush (%%rsi);"
+                "mfence;"
+                : "=a" (a)
+                : "c" (addr1), "S" (addr2)
+                : "%rdx", "%r8", "%r9", "%r10", "memory"
+     );
+    return a;
+}
+
+/** measures one load (BENCHIT_KERNEL_VICTIM_PATH)
+ *  @return cycles including the rdtsc latency
+ */
+unsigned long long asm_line_latency(unsigned long long addr)
+{
+   unsigned long long a;
+
+     /*
+      * Input:  RCX: addr
+      * Output: RAX: duration
+      */
+     __asm__ __volatile__(
+                "mfence;"
+                "lfence;"
+                TIMESTAMP
+                "mov %%rax,%%r8;"
+                "mov (%%rcx), %%r9;"
+                "lfence;"
+                TIMESTAMP
+                "sub %%r8,%%rax;"
+                : "=a" (a)
+                : "c" (addr)
+                : "%rdx", "%r8", "%r9", "memory"
+     );
+    return a;
+}
+
+/* operations before each fence in asm_fence_loop() (BENCHIT_KERNEL_FENCE_COST)
+ * R8: loop counter, R10: buffer, R11: mask, R12: offset of the next miss, R13: pointer to itself */
+#define FENCE_OPS_NONE   ""
+#define FENCE_OPS_STORES "mov %%r8,(%%r10);mov %%r8,64(%%r10);mov %%r8,128(%%r10);mov %%r8,192(%%r10);"
+#define FENCE_OPS_MISSES "mov (%%r10,%%r12),%%rdx;add $4160,%%r12;and %%r11,%%r12;"
+#define FENCE_OPS_CHASE  "mov (%%r13),%%r13;"
+
+#define FENCE_LOOP(ops,fence) \
+     __asm__ __volatile__( \
+                "mov %1,%%r8;" \
+                "mov %2,%%r10;" \
+                "mov %3,%%r11;" \
+                "xor %%r12,%%r12;" \
+                "lea 512(%%r10),%%r13;" \
+                "mov %%r13,(%%r13);" \
+                "mfence;" \
+                TIMESTAMP \
+                "mov %%rax,%%r9;" \
+                ".align 64,0x90;" \
+                "1:" \
+                ops \
+                fence \
+                "sub $1,%%r8;" \
+                "jnz 1b;" \
+                "mfence;" \
+                TIMESTAMP \
+                "sub %%r9,%%rax;" \
+                : "=&a" (a) \
+                : "r" (iterations), "r" (buffer), "r" (mask) \
+                : "%rbx", "%rcx", "%rdx", "%r8", "%r9", "%r10", "%r11", "%r12", "%r13", "memory" \
+     )
+
+#define FENCE_CONTEXT(fence) \
+     if (context==FENCE_CONTEXT_STORES) FENCE_LOOP(FENCE_OPS_STORES,fence); \
+     else if (context==FENCE_CONTEXT_MISSES) FENCE_LOOP(FENCE_OPS_MISSES,fence); \
+     else if (context==FENCE_CONTEXT_CHASE) FENCE_LOOP(FENCE_OPS_CHASE,fence); \
+     else FENCE_LOOP(FENCE_OPS_NONE,fence)
+
+/** loop with one fence or serializing instruction per iteration (BENCHIT_KERNEL_FENCE_COST)
+ *  lock and xchg access a line of the buffer that is not used by the context operations
+ */
+unsigned long long asm_fence_loop(int type, int context, unsigned long long iterations, char *buffer, unsigned long long mask)
+{
+   unsigned long long a=0;
+
+   if (!iterations) return 0;
+
+   switch (type){
+     case FENCE_MFENCE:    FENCE_CONTEXT("mfence;"); break;
+     case FENCE_SFENCE:    FENCE_CONTEXT("sfence;"); break;
+     case FENCE_LFENCE:    FENCE_CONTEXT("lfence;"); break;
+     case FENCE_LOCK:      FENCE_CONTEXT("lock addq $0,256(%%r10);"); break;
+     case FENCE_XCHG:      FENCE_CONTEXT("xchg %%rdx,256(%%r10);"); break;
+     case FENCE_CPUID:     FENCE_CONTEXT("xor %%eax,%%eax;cpuid;"); break;
+     case FENCE_SERIALIZE: FENCE_CONTEXT(".byte 0x0f,0x01,0xe8;"); break;
+     default:              FENCE_CONTEXT(""); break;
+   }
+   return a;
+}
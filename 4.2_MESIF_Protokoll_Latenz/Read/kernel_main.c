@@ -27,6 +27,7 @@
 
 /*  Header for local functions */
 #include "work.h"
+#include "analysis.h"
 
 #ifdef USE_PAPI
 #include <papi.h>
@@ -44,7 +45,50 @@ int HUGEPAGES=0,RUNS=0,EXTRA_CLFLUSH=0,OFFSET=0,FUNCTION=0,BURST_LENGTH=0,RANDOM
 int ALIGNMENT=64,NUM_RESULTS=0,TIMEOUT=0,NUM_THREADS=0,LOOP_OVERHEAD_COMPENSATION=0;
 int EXTRA_FLUSH_SIZE=0,GLOBAL_FLUSH_BUFFER=0,DISABLE_CLFLUSH=1;
 int FLUSH_L1=0,FLUSH_L2=0,FLUSH_L3=0,FLUSH_L4=0,NUM_FLUSHES=0,NUM_USES=0,FLUSH_MODE=0,ENABLE_CODE_PREFETCH=0,FLUSH_SHARED_CPU=0;
-int ACCESSES=0,TLB_MODE=0,FLUSH_PT,USE_MODE=0,FRST_SHARE_CPU=0,NUM_SHARED_CPUS=0,ALWAYS_FLUSH_CPU0=0;
+int ACCESSES=0,TLB_MODE=0,FLUSH_PT,USE_MODE=0,FRST_SHARE_CPU=0,NUM_SHARED_CPUS=0,ALWAYS_FLUSH_CPU0=0,FLUSH_TARGETED=0;
+int NOISE_REJECTION=0,NOISE_RETRIES=10,SCHED_PRIO=0,MLOCK_MEMORY=0;
+int SHARER_SCALING=0,CONCURRENT_READERS=0,LAZY_INIT=0;
+int SAMPLE_DURATION=0,SAMPLE_PASSES=1;
+unsigned long long SAMPLE_SIZE=0,SAMPLE_MAX=1000000;
+char *SAMPLE_FILE=NULL;
+int PAGE_FAULT_MODE=PAGE_FAULT_OFF,PROCESS_MODE=0,CODE_LATENCY=CODE_LATENCY_OFF;
+char *PAGE_FAULT_NAME="",*CODE_LATENCY_NAME="";
+int NUM_SWEEP_CPUS=0,VERIFY_PLACEMENT_MODE=0;
+unsigned long long SWEEP_MAX=0;
+double *sweep_results=NULL;
+int *sweep_index=NULL;
+int PLATEAU_ANALYSIS=0,PLATEAU_MIN_POINTS=3;
+char *PLATEAU_FILE=NULL,*USE_MODE_NAME="E";
+double *plateau_sizes=NULL,*plateau_cycles=NULL;
+unsigned long long CHAIN_SEED=0;
+char *CHAIN_CACHE_DIR=NULL;
+int SMT_LOAD=SMT_LOAD_OFF,SMT_CPU=-1;
+unsigned long long SMT_LOAD_SIZE=0;
+char *SMT_LOAD_NAME="";
+int DRAM_MODE=DRAM_MODE_OFF,DRAM_NUM_FUNCTIONS=0,DRAM_ROW_SHIFT=18,DRAM_SOLVE=0,DRAM_SOLVE_SAMPLES=4096;
+unsigned long long DRAM_FUNCTIONS[DRAM_MAX_FUNCTIONS],DRAM_SOLVE_SIZE=256*1024*1024,DRAM_THRESHOLD=0;
+char *DRAM_MODE_NAME="";
+int STRUCTURE=STRUCTURE_OFF;
+char *STRUCTURE_NAME="";
+int WAKEUP_MODE=WAKEUP_OFF,WAKEUP_SAMPLES=200;
+char *WAKEUP_NAME="";
+double *wakeup_percentiles=NULL;
+int FENCE_COST=0;
+unsigned long long FENCE_ITERATIONS=100000;
+int PREFETCH_ADVISOR=PREFETCH_OFF,PREFETCH_DISTANCES[32]={1,2,4,8,16,32,64},PREFETCH_NUM_DISTANCES=7;
+unsigned long long PREFETCH_ACCESSES=1000000;
+char *PREFETCH_ADVISOR_NAME="";
+int STORE_FORWARDING=0,ALIASING_DISTANCES[32]={0,8,64,2048,4032,4088,4096,4104,4160,8192,12288,65536},ALIASING_NUM_DISTANCES=12;
+unsigned long long FORWARD_ITERATIONS=100000;
+int INTERLEAVED_LOOKUPS=0,INTERLEAVED_GROUPS[INTERLEAVED_MAX_GROUPS]={1,2,4,8,16,32},INTERLEAVED_NUM_GROUPS=6;
+unsigned long long INTERLEAVED_ACCESSES=1000000;
+int VICTIM_PATH=0;
+unsigned long long VICTIM_LINES=0,VICTIM_THRESHOLD=0;
+scenario_t *scenarios=NULL;
+int NUM_SCENARIOS=0,SCENARIO_SHARED=0,NUM_COLUMNS=0;
+char *SCENARIO_FILE=NULL;
+/* result columns per work: thread and scenario of each column, identity mapping without scenarios */
+int *column_thread=NULL,*column_scenario=NULL;
 
 
 /* string used for error message */
@@ -123,6 +167,668 @@ static void *watchdog_timer(void *arg){
   pthread_exit(0);
 }
 
+/** reads a CPU list from sysfs (format: "0-1,8,10-11") into set
+ *  @return 0 on success, -1 if the file is not readable
+ */
+static int read_cpu_list(char *file, cpu_set_t *set)
+{
+  char buf[256],*p,*q,*r;
+  int i;
+  FILE *f;
+
+  CPU_ZERO(set);
+  f=fopen(file,"r");
+  if (f==NULL) return -1;
+  if (fgets(buf,sizeof(buf),f)==NULL) {fclose(f);return -1;}
+  fclose(f);
+
+  p=buf;
+  do{
+    q=strstr(p,",");if (q) {*q='\0';q++;}
+    r=strstr(p,"-");if (r) {*r='\0';r++;}
+    /* empty lists contain only the newline */
+    if ((*p>='0')&&(*p<='9')){
+      if (r) {for (i=atoi(p);(i<=atoi(r))&&(i<CPU_SETSIZE);i++) CPU_SET(i,set);}
+      else if (atoi(p)<CPU_SETSIZE) CPU_SET(atoi(p),set);
+    }
+    p=q;
+  }while(p!=NULL);
+
+  return 0;
+}
+
+/** checks whether two CPUs share a level 2 cache
+ *  - returns 1 if cpu_a and cpu_b share a L2, 0 if not, -1 if the cache topology is not available in sysfs
+ */
+static int shares_l2(int cpu_a, int cpu_b)
+{
+  char path[128];
+  cpu_set_t set;
+  int i,level,ret=-1;
+  FILE *f;
+
+  for (i=0;i<8;i++){
+    sprintf(path,"/sys/devices/system/cpu/cpu%i/cache/index%i/level",cpu_a,i);
+    f=fopen(path,"r");
+    if (f==NULL) break;
+    level=0;
+    if (fscanf(f,"%i",&level)!=1) level=0;
+    fclose(f);
+    if (level!=2) continue;
+
+    sprintf(path,"/sys/devices/system/cpu/cpu%i/cache/index%i/shared_cpu_list",cpu_a,i);
+    if (read_cpu_list(path,&set)) break;
+    ret=0;
+    if (CPU_ISSET(cpu_b,&set)) {ret=1;break;}
+  }
+
+  return ret;
+}
+
+/** determines the SMT sibling of cpu from /sys/devices/system/cpu/cpuX/topology/thread_siblings_list
+ *  @return first other CPU in the list, -1 if there is none or the topology is unknown
+ */
+static int smt_sibling(int cpu)
+{
+  char path[128];
+  cpu_set_t set;
+  int i;
+
+  sprintf(path,"/sys/devices/system/cpu/cpu%i/topology/thread_siblings_list",cpu);
+  if (read_cpu_list(path,&set)) return -1;
+  for (i=0;i<CPU_SETSIZE;i++) if ((i!=cpu)&&(CPU_ISSET(i,&set))) return i;
+
+  return -1;
+}
+
+/** checks if cpu is contained in the CPU list in file (e.g. "0-15,20") */
+static int cpu_in_list(char *file, int cpu)
+{
+  cpu_set_t set;
+
+  if (read_cpu_list(file,&set)) return 0;
+  return CPU_ISSET(cpu,&set);
+}
+
+/** core type of cpu on hybrid processors (performance or efficient cores), empty string otherwise */
+static char *core_type(int cpu)
+{
+  if (cpu_in_list("/sys/devices/cpu_core/cpus",cpu)) return " (P-core)";
+  if (cpu_in_list("/sys/devices/cpu_atom/cpus",cpu)) return " (E-core)";
+  return "";
+}
+
+/** runs a pre-measurement analysis once on each distinct CPU in CPU_LIST, bound to that CPU
+ *  the thread is bound to the first CPU again afterwards
+ */
+static void for_each_cpu(volatile mydata_t *mdp, void (*analysis)(volatile mydata_t *mdp, unsigned long long cpu))
+{
+  int i,j;
+
+  for (i=0;i<NUM_THREADS;i++){
+    for (j=0;j<i;j++) if (cpu_bind[j]==cpu_bind[i]) break;
+    if (j<i) continue;
+    cpu_set(cpu_bind[i]);
+    analysis(mdp,cpu_bind[i]);
+    fflush(stdout);
+  }
+  cpu_set(cpu_bind[0]);
+}
+
+/** measures fences and serializing instructions on cpu (BENCHIT_KERNEL_FENCE_COST)
+ *  the buffer for the outstanding misses is at least 4 times larger than all caches
+ */
+static void fence_cost(volatile mydata_t *mdp, unsigned long long cpu)
+{
+  char *names[FENCE_TYPES]={"loop","mfence","sfence","lfence","lock add","xchg","cpuid","serialize"};
+  double cycles[FENCE_TYPES*FENCE_CONTEXTS],c;
+  unsigned long long size=64*1024*1024;
+  int type,context;
+
+  while (size<4*mdp->cpuinfo->Cacheflushsize) size*=2;
+  measure_fences(size,FENCE_ITERATIONS,cycles);
+  printf("  fence cost CPU%llu%s, loop: cycles per iteration, instructions: added cycles per instruction\n",cpu,core_type(cpu));
+  printf("    %-10s %10s %10s %10s %10s\n","","alone","stores","misses","L1 chase");
+  for (type=0;type<FENCE_TYPES;type++){
+    printf("    %-10s",names[type]);
+    for (context=0;context<FENCE_CONTEXTS;context++){
+      c=cycles[type*FENCE_CONTEXTS+context];
+      if (c<0) printf(" %10s","n/a");
+      else if (type==FENCE_NONE) printf(" %10.1f",c);
+      else printf(" %10.1f",c-cycles[context]);
+    }
+    printf("\n");
+  }
+}
+
+/** measures store-to-load forwarding and 4K aliasing on cpu (BENCHIT_KERNEL_STORE_FORWARDING)
+ */
+static void store_forwarding(volatile mydata_t *mdp, unsigned long long cpu)
+{
+  char *names[FORWARD_CASES]={"matched 8 Byte","matched 4 Byte","matched 1 Byte",
+                              "4 Byte load from Byte 0 of 8 Byte store","4 Byte load from Byte 4 of 8 Byte store","1 Byte load from Byte 7 of 8 Byte store",
+                              "8 Byte load from 4 Byte store","8 Byte load overlapping Bytes 4-7 of 8 Byte store",
+                              "matched 8 Byte, offset 1","matched 8 Byte, offset 5",
+                              "matched 8 Byte, cacheline split (offset 60)","matched 4 Byte, cacheline split (offset 62)",
+                              "matched 8 Byte, page split (offset 4092)"};
+  double renamed_cycles[FORWARD_CASES],forwarded_cycles[FORWARD_CASES],aliasing[32];
+  int c,d;
+
+  measure_forwarding(FORWARD_ITERATIONS,renamed_cycles,forwarded_cycles);
+  measure_aliasing(FORWARD_ITERATIONS,ALIASING_DISTANCES,ALIASING_NUM_DISTANCES,aliasing);
+  printf("  store-to-load forwarding CPU%llu%s, cycles per dependent store/load pair\n",cpu,core_type(cpu));
+  printf("    %-52s %9s %9s\n","","forwarded","renamed");
+  for (c=0;c<FORWARD_CASES;c++) printf("    %-52s %9.1f %9.1f\n",names[c],forwarded_cycles[c],renamed_cycles[c]);
+  printf("  4K aliasing CPU%llu%s, cycles per store/load pair, load address - store address in Byte\n",cpu,core_type(cpu));
+  for (d=0;d<ALIASING_NUM_DISTANCES;d++){
+    printf("    %8i %6.1f",ALIASING_DISTANCES[d],aliasing[d]);
+    if (ALIASING_DISTANCES[d]==0) printf(" (forwarding)");
+    else if (ALIASING_DISTANCES[d]%4096==0) printf(" (4K aliased)");
+    printf("\n");
+  }
+}
+
+/** attribute (size, ways_of_associativity, ...) of the data or unified cache of level on cpu from
+ *  /sys/devices/system/cpu/cpuX/cache/, 0 if unknown
+ */
+static unsigned long long sysfs_cache_attribute(int cpu, int level, char *attribute)
+{
+  char path[128],buf[32];
+  unsigned long long size=0;
+  int i,l;
+  FILE *f;
+
+  for (i=0;i<8;i++){
+    sprintf(path,"/sys/devices/system/cpu/cpu%i/cache/index%i/level",cpu,i);
+    f=fopen(path,"r");
+    if (f==NULL) break;
+    l=0;
+    if (fscanf(f,"%i",&l)!=1) l=0;
+    fclose(f);
+    if (l!=level) continue;
+
+    sprintf(path,"/sys/devices/system/cpu/cpu%i/cache/index%i/type",cpu,i);
+    f=fopen(path,"r");
+    if (f==NULL) break;
+    if (fgets(buf,sizeof(buf),f)==NULL) buf[0]='\0';
+    fclose(f);
+    if (!strncmp(buf,"Instruction",11)) continue;
+
+    sprintf(path,"/sys/devices/system/cpu/cpu%i/cache/index%i/%s",cpu,i,attribute);
+    f=fopen(path,"r");
+    if (f==NULL) break;
+    if (fgets(buf,sizeof(buf),f)!=NULL){
+      size=strtoull(buf,NULL,10);
+      if (strchr(buf,'K')) size*=1024;
+      if (strchr(buf,'M')) size*=1024*1024;
+    }
+    fclose(f);
+    break;
+  }
+  return size;
+}
+
+/** capacity of the data or unified cache of level on cpu from sysfs, 0 if the level does not exist
+ *  BENCHIT_KERNEL_Lx_SIZE and the hardware detection are only used if sysfs does not describe the caches of cpu,
+ *  they do not distinguish the core types of hybrid processors
+ */
+static unsigned long long level_size(volatile mydata_t *mdp, int cpu, int level)
+{
+  unsigned long long size;
+
+  size=sysfs_cache_attribute(cpu,level,"size");
+  if ((size)||(sysfs_cache_attribute(cpu,1,"size"))) return size;
+  return mdp->cpuinfo->U_Cache_Size[level-1]+mdp->cpuinfo->D_Cache_Size[level-1];
+}
+
+/** number of cache levels of cpu used by the analyses, levels with unknown size (0) end the list,
+ *  levels above half of ANALYSIS_MAX_SIZE (e.g. an L4_SIZE used for flushing) are left out, so that the memory data set
+ *  is at least twice the last level
+ */
+static int analysis_levels(volatile mydata_t *mdp, int cpu)
+{
+  unsigned long long size;
+  int levels;
+
+  for (levels=0;levels<4;levels++){
+    size=level_size(mdp,cpu,levels+1);
+    if ((size==0)||(size>ANALYSIS_MAX_SIZE/2)) break;
+  }
+  return levels;
+}
+
+/** data set size for level l of cpu, between the capacities of level l-1 and l, 4 times the last level for memory (l=levels+1)
+ *  at most ANALYSIS_MAX_SIZE, name is set to "Lx" or "memory"
+ */
+static unsigned long long analysis_size(volatile mydata_t *mdp, int cpu, int l, int levels, char *name)
+{
+  unsigned long long size,lower=0;
+
+  if (l>1) lower=level_size(mdp,cpu,l-1);
+  if (l<=levels){
+    size=(lower+level_size(mdp,cpu,l))/2;
+    sprintf(name,"L%i",l);
+  }
+  else{
+    size=4*lower;
+    if (size>ANALYSIS_MAX_SIZE) size=ANALYSIS_MAX_SIZE;
+    sprintf(name,"memory");
+  }
+  return (size+4095)&~4095ULL;
+}
+
+/** measures software prefetching on cpu (BENCHIT_KERNEL_PREFETCH_ADVISOR)
+ *  one data set size per cache level (between the capacity of the level and the level above) and memory (4 times the last level),
+ *  the cache sizes of each CPU are taken from sysfs so that the core types of hybrid processors get their own sizes
+ *  prints the cycles per access for all prefetch instructions and distances and recommends the best combination per level
+ */
+static void prefetch_advisor(volatile mydata_t *mdp, unsigned long long cpu)
+{
+  char *names[PREFETCH_TYPES]={"none","prefetcht0","prefetcht1","prefetcht2","prefetchnta","prefetchw"};
+  char level_name[16];
+  double *cycles,c,best;
+  unsigned long long size;
+  int l,levels,type,d,best_type,best_d;
+
+  cycles=(double*)malloc(PREFETCH_TYPES*PREFETCH_NUM_DISTANCES*sizeof(double));
+  if (cycles==NULL){
+    fprintf( stderr, "Error: Allocation of prefetch advisor results failed\n" ); fflush( stderr );
+    exit( 127 );
+  }
+  levels=analysis_levels(mdp,cpu);
+  if (levels==0){
+    printf("  Warning: cache sizes of CPU%llu are unknown, skipping the prefetch advisor\n",cpu);
+    free(cycles);
+    return;
+  }
+  printf("  prefetch advisor CPU%llu%s, %s pattern, cycles per access for prefetch distances (accesses ahead)\n",cpu,core_type(cpu),PREFETCH_ADVISOR_NAME);
+  for (l=1;l<=levels+1;l++){
+    size=analysis_size(mdp,cpu,l,levels,level_name);
+    measure_prefetch(PREFETCH_ADVISOR,size,PREFETCH_ACCESSES,PREFETCH_DISTANCES,PREFETCH_NUM_DISTANCES,cycles);
+
+    printf("    %s (%llu Byte)\n      %-12s",level_name,size,"distance");
+    for (d=0;d<PREFETCH_NUM_DISTANCES;d++) printf(" %7i",PREFETCH_DISTANCES[d]);
+    printf("\n");
+    best=cycles[0];best_type=PREFETCH_NONE;best_d=0;
+    for (type=0;type<PREFETCH_TYPES;type++){
+      printf("      %-12s",names[type]);
+      for (d=0;d<PREFETCH_NUM_DISTANCES;d++){
+        c=cycles[type*PREFETCH_NUM_DISTANCES+d];
+        if (c<0) printf(" %7s","n/a");
+        else if (type==PREFETCH_NONE) {printf(" %7.1f",c);break;}
+        else printf(" %7.1f",c);
+        if ((c>0)&&(c<best)) {best=c;best_type=type;best_d=d;}
+      }
+      printf("\n");
+    }
+    /* prefetching has to save at least 5% to be recommended */
+    if ((best_type==PREFETCH_NONE)||(best>0.95*cycles[0])) printf("      recommendation: no software prefetch (%.1f cycles per access)\n",cycles[0]);
+    else printf("      recommendation: %s, distance %i (%.1f instead of %.1f cycles per access)\n",names[best_type],PREFETCH_DISTANCES[best_d],best,cycles[0]);
+  }
+  free(cycles);
+}
+
+/** measures interleaved lookups on cpu (BENCHIT_KERNEL_INTERLEAVED_LOOKUPS)
+ *  one data set size per cache level and memory like the prefetch advisor
+ *  prints the throughput (cycles per lookup) and the latency of each lookup for all group sizes, the first group size
+ *  that is faster than the smallest one, and the group size that reaches the best throughput
+ */
+static void interleaved_lookups(volatile mydata_t *mdp, unsigned long long cpu)
+{
+  char level_name[16];
+  double cycles[INTERLEAVED_MAX_GROUPS],best;
+  unsigned long long size;
+  int l,levels,g,first_gain,saturation;
+
+  levels=analysis_levels(mdp,cpu);
+  if (levels==0){
+    printf("  Warning: cache sizes of CPU%llu are unknown, skipping the interleaved lookups\n",cpu);
+    return;
+  }
+  printf("  interleaved lookups CPU%llu%s, %i dependent accesses per lookup, cycles for G interleaved lookups\n",cpu,core_type(cpu),INTERLEAVED_LOOKUP_LENGTH);
+  for (l=1;l<=levels+1;l++){
+    size=analysis_size(mdp,cpu,l,levels,level_name);
+    measure_interleaved(size,INTERLEAVED_ACCESSES,INTERLEAVED_GROUPS,INTERLEAVED_NUM_GROUPS,cycles);
+
+    printf("    %s (%llu Byte)\n      %-12s",level_name,size,"G");
+    for (g=0;g<INTERLEAVED_NUM_GROUPS;g++) printf(" %7i",INTERLEAVED_GROUPS[g]);
+    printf("\n      %-12s","throughput");
+    for (g=0;g<INTERLEAVED_NUM_GROUPS;g++) printf(" %7.1f",cycles[g]*INTERLEAVED_LOOKUP_LENGTH);
+    printf("\n      %-12s","latency");
+    for (g=0;g<INTERLEAVED_NUM_GROUPS;g++) printf(" %7.1f",cycles[g]*INTERLEAVED_LOOKUP_LENGTH*INTERLEAVED_GROUPS[g]);
+    printf("\n");
+    /* group sizes have to save at least 5% to count as faster */
+    best=cycles[0];first_gain=-1;saturation=0;
+    for (g=1;g<INTERLEAVED_NUM_GROUPS;g++){
+      if ((first_gain<0)&&(cycles[g]<0.95*cycles[0])) first_gain=g;
+      if (cycles[g]<best) best=cycles[g];
+    }
+    for (g=0;g<INTERLEAVED_NUM_GROUPS;g++) if (cycles[g]<=best/0.95) {saturation=g;break;}
+    if (first_gain<0) printf("      crossover: no group size is faster than G=%i\n",INTERLEAVED_GROUPS[0]);
+    else printf("      crossover: G=%i is faster than G=%i, G=%i reaches %.1f cycles per lookup (%.1f times faster)\n",INTERLEAVED_GROUPS[first_gain],INTERLEAVED_GROUPS[0],INTERLEAVED_GROUPS[saturation],cycles[saturation]*INTERLEAVED_LOOKUP_LENGTH,cycles[0]/cycles[saturation]);
+  }
+}
+
+/** measures where clean and dirty lines evicted from L2 are found on cpu (BENCHIT_KERNEL_VICTIM_PATH)
+ *  the L2 size and associativity of each CPU are taken from sysfs so that the core types of hybrid processors use their own
+ */
+static void victim_path(volatile mydata_t *mdp, unsigned long long cpu)
+{
+  char *kinds[VICTIM_KINDS]={"clean","dirty"};
+  victim_result_t results[VICTIM_KINDS];
+  unsigned long long l2_size,l2_ways,lines,total,thresholds[2];
+  int kind,src,conflict;
+
+  l2_size=level_size(mdp,cpu,2);
+  l2_ways=sysfs_cache_attribute(cpu,2,"ways_of_associativity");
+  if (!l2_ways) l2_ways=mdp->cpuinfo->U_Cache_Sets[1]+mdp->cpuinfo->D_Cache_Sets[1];
+  if (l2_size<4096){
+    printf("  Warning: L2 size of CPU%llu is unknown, skipping the victim measurement\n",cpu);
+    return;
+  }
+  lines=VICTIM_LINES;
+  if (!lines) lines=l2_size/4/64;
+  thresholds[0]=0;thresholds[1]=VICTIM_THRESHOLD;
+  conflict=measure_victims(l2_size,l2_ways,lines,thresholds,results);
+  printf("  L2 victims CPU%llu%s, %llu lines, %s sweep, share of lines and median cycles per source (including the rdtsc latency)\n",cpu,core_type(cpu),lines,conflict?"conflict":"full");
+  printf("    sources: L1/L2 below %llu cycles, LLC below %llu cycles, DRAM\n",thresholds[0],thresholds[1]);
+  printf("    %-6s %18s %18s %18s\n","","L1/L2","LLC","DRAM");
+  for (kind=0;kind<VICTIM_KINDS;kind++){
+    printf("    %-6s",kinds[kind]);
+    total=0;
+    for (src=0;src<VICTIM_SOURCES;src++) total+=results[kind].lines[src];
+    for (src=0;src<VICTIM_SOURCES;src++) printf("   %5.1f%% %7.1f",100.0*results[kind].lines[src]/(double)total,results[kind].latency[src]);
+    printf("\n");
+  }
+}
+
+/** determines the DRAM bank functions on the first CPU (BENCHIT_KERNEL_DRAM_SOLVE)
+ *  the functions are used for BENCHIT_KERNEL_DRAM_MODE if BENCHIT_KERNEL_DRAM_BANK_FUNCTIONS is not set
+ */
+static void dram_solver(void)
+{
+  unsigned long long functions[DRAM_MAX_FUNCTIONS];
+  int i,n;
+
+  printf("  DRAM solver: measuring %i lines in %llu Byte on CPU %llu\n",DRAM_SOLVE_SAMPLES,DRAM_SOLVE_SIZE,cpu_bind[0]);fflush(stdout);
+  n=solve_dram_functions(DRAM_SOLVE_SIZE,DRAM_SOLVE_SAMPLES,DRAM_THRESHOLD,functions,DRAM_MAX_FUNCTIONS);
+  if (n<0){
+    fprintf( stderr, "Error: BENCHIT_KERNEL_DRAM_SOLVE requires physical addresses from /proc/self/pagemap (CAP_SYS_ADMIN)\n" ); fflush( stderr );
+    exit( 127 );
+  }
+  printf("  DRAM solver: %i bank functions, BENCHIT_KERNEL_DRAM_BANK_FUNCTIONS=\"",n);
+  for (i=0;i<n;i++) printf("%s0x%llx",i?",":"",functions[i]);
+  printf("\"\n");fflush(stdout);
+  if (DRAM_NUM_FUNCTIONS==0){
+    for (i=0;i<n;i++) DRAM_FUNCTIONS[i]=functions[i];
+    DRAM_NUM_FUNCTIONS=n;
+  }
+}
+
+/** prints the NUMA nodes and page sizes of the buffers of all threads (BENCHIT_KERNEL_VERIFY_PLACEMENT)
+ */
+static void report_placement(volatile mydata_t *mdp)
+{
+  placement_t placement;
+  unsigned long long misplaced,size;
+  char *buffer;
+  int t,i,node,unknown_size=0;
+
+  printf("  page placement:\n");
+  for (t=0;t<mdp->num_threads;t++){
+    if (t) {buffer=mdp->threaddata[t].buffer;size=mdp->threaddata[t].buffersize;}
+    else {buffer=mdp->buffer;size=BUFFERSIZE;}
+    node=numa_node_of_cpu(mem_bind[t]);
+    misplaced=check_placement(buffer,size,node,(HUGEPAGES==HUGEPAGES_ON),&placement);
+    printf("    - Thread %i (CPU %llu), memory bound to node %i: %llu pages",t,cpu_bind[t],node,placement.pages);
+    for (i=0;i<PLACEMENT_MAX_NODES;i++) if (placement.nodes[i]) printf(", node %i: %llu",i,placement.nodes[i]);
+    if (placement.unknown_node) printf(", node unknown: %llu",placement.unknown_node);
+    if (placement.not_present) printf(", not present: %llu",placement.not_present);
+    printf(", in huge pages: %llu, in small pages: %llu",placement.huge_pages,placement.small_pages);
+    if (placement.unknown_size) {printf(", page size unknown: %llu",placement.unknown_size);unknown_size=1;}
+    printf("\n");
+    if (misplaced) printf("  Warning: %llu pages of thread %i are not placed as requested\n",misplaced,t);
+  }
+  if (unknown_size) printf("  page sizes require access to /proc/kpageflags and the PFNs in /proc/self/pagemap (CAP_SYS_ADMIN)\n");
+  fflush(stdout);
+}
+
+/** fits a piecewise-constant model to the latency curves (cycles) of all CPUs (BENCHIT_KERNEL_PLATEAU_ANALYSIS)
+ *  prints the plateaus and writes them to PLATEAU_FILE
+ */
+static void plateau_analysis(volatile mydata_t *mdp)
+{
+  plateau_t *plateaus;
+  double *latencies;
+  char *state;
+  int i,k,n;
+  FILE *f;
+
+  plateaus=(plateau_t*)malloc(problemlistsize*sizeof(plateau_t));
+  latencies=(double*)malloc(problemlistsize*sizeof(double));
+  if ((plateaus==NULL)||(latencies==NULL)){
+    fprintf( stderr, "Warning: Allocation of plateau analysis failed\n" ); fflush( stderr );
+    free(plateaus);free(latencies);
+    return;
+  }
+  if (PAGE_FAULT_MODE) state=PAGE_FAULT_NAME;
+  else if (CODE_LATENCY) state=CODE_LATENCY_NAME;
+  else state=USE_MODE_NAME;
+
+  f=fopen(PLATEAU_FILE,"w");
+  if (f==NULL) {fprintf( stderr, "Warning: could not create plateau file %s\n",PLATEAU_FILE ); fflush( stderr );}
+  else fprintf(f,"cpu,data_cpu,state,segment,first_size,last_size,points,latency_cycles,ci_cycles,latency_ns,ci_ns,capacity,flat\n");
+
+  printf("\n  latency plateaus (mean latency, 95%% confidence interval, boundary to the next segment):\n");
+  for (k=0;k<NUM_RESULTS;k++){
+    for (i=0;i<problemlistsize;i++) latencies[i]=plateau_cycles[i*NUM_RESULTS+k];
+    n=find_plateaus(plateau_sizes,latencies,problemlistsize,PLATEAU_MIN_POINTS,plateaus);
+    if (k) printf("    - CPU%llu accessing CPU%llu memory, state %s:\n",cpu_bind[0],cpu_bind[k],state);
+    else printf("    - CPU%llu locally, state %s:\n",cpu_bind[0],state);
+    for (i=0;i<n;i++){
+      printf("      %12.0f - %12.0f Byte: %8.2f +- %6.2f cycles (%8.2f ns)",plateaus[i].first_size,plateaus[i].last_size,plateaus[i].latency,plateaus[i].ci,plateaus[i].latency/mdp->cpuinfo->clockrate*1000000000);
+      if (plateaus[i].capacity>0) printf(", boundary %.0f Byte",plateaus[i].capacity);
+      if (!plateaus[i].flat) printf(", transition");
+      printf("\n");
+      if (f) fprintf(f,"%llu,%llu,%s,%i,%.0f,%.0f,%i,%.3f,%.3f,%.3f,%.3f,%.0f,%i\n",cpu_bind[0],cpu_bind[k],state,i,plateaus[i].first_size,plateaus[i].last_size,plateaus[i].points,
+                     plateaus[i].latency,plateaus[i].ci,plateaus[i].latency/mdp->cpuinfo->clockrate*1000000000,plateaus[i].ci/mdp->cpuinfo->clockrate*1000000000,plateaus[i].capacity,plateaus[i].flat);
+    }
+  }
+  fflush(stdout);
+  if (f) fclose(f);
+  free(plateaus);free(latencies);
+}
+
+/** converts the name of a coherence state (BENCHIT_KERNEL_USE_MODE) into the mode, -1 if invalid */
+static int parse_use_mode(char *p)
+{
+  if (!strcmp(p,"M")) return MODE_MODIFIED;
+  if (!strcmp(p,"E")) return MODE_EXCLUSIVE;
+  if (!strcmp(p,"I")) return MODE_INVALID;
+  if (!strcmp(p,"S")) return MODE_SHARED;
+  if (!strcmp(p,"O")) return MODE_OWNED;
+  if (!strcmp(p,"F")) return MODE_FORWARD;
+  if (!strcmp(p,"U")) return MODE_MUW;
+  return -1;
+}
+
+/** converts the name of a flush mode (BENCHIT_KERNEL_FLUSH_MODE) into the mode, -1 if invalid */
+static int parse_flush_mode(char *p)
+{
+  if (!strcmp(p,"M")) return MODE_MODIFIED;
+  if (!strcmp(p,"E")) return MODE_EXCLUSIVE;
+  if (!strcmp(p,"I")) return MODE_INVALID;
+  if (!strcmp(p,"R")) return MODE_RDONLY;
+  return -1;
+}
+
+/** name of a coherence state or flush mode */
+static char *mode_name(int mode)
+{
+  switch (mode){
+    case MODE_MODIFIED: return "M";
+    case MODE_EXCLUSIVE: return "E";
+    case MODE_INVALID: return "I";
+    case MODE_SHARED: return "S";
+    case MODE_OWNED: return "O";
+    case MODE_FORWARD: return "F";
+    case MODE_MUW: return "U";
+    case MODE_RDONLY: return "R";
+  }
+  return "?";
+}
+
+/** reads the comma separated list in the environment variable name into array (e.g. BENCHIT_KERNEL_PREFETCH_DISTANCES)
+ *  - at most max values, each between lo and hi
+ *  @return number of values, 0 if the variable is not set or empty, -1 if invalid (described in error_msg)
+ */
+static int parse_int_list(char *name, int *array, int max, int lo, int hi)
+{
+  char *p,*q;
+  int n=0;
+
+  p=bi_getenv(name,0);
+  if ((p==NULL)||(strlen(p)==0)) return 0;
+  p=bi_strdup(p);
+  do{
+    q=strstr(p,",");if (q) {*q='\0';q++;}
+    if (n>=max) {sprintf(error_msg,"%s supports up to %i values",name,max);return -1;}
+    array[n]=atoi(p);
+    if ((array[n]<lo)||(array[n]>hi)) {sprintf(error_msg,"invalid setting for %s",name);return -1;}
+    n++;
+    p=q;
+  }while(p!=NULL);
+  return n;
+}
+
+/** reads the scenarios from file (BENCHIT_KERNEL_SCENARIO_FILE)
+ *  - one scenario per line: name followed by KEY=VALUE pairs, settings that are not specified are taken from the PARAMETERS file
+ *  - keys: USE_MODE, USE_ACCESSES, FLUSH_MODE, FLUSH_ACCESSES, FLUSH_L1 to FLUSH_L4, ALIGNMENT and CPU_LIST
+ *  - CPU_LIST selects CPUs from BENCHIT_KERNEL_CPU_LIST, the first CPU has to be the first CPU in BENCHIT_KERNEL_CPU_LIST
+ *  @return number of errors, the last one is described in error_msg
+ */
+static int read_scenarios(char *file)
+{
+  char line[1024],*p,*q,*r,*value;
+  scenario_t *sc;
+  int i,t,cpu,errors=0,lineno=0;
+  FILE *f;
+
+  f=fopen(file,"r");
+  if (f==NULL) {sprintf(error_msg,"could not open BENCHIT_KERNEL_SCENARIO_FILE %s",file);return 1;}
+  while (fgets(line,sizeof(line),f)!=NULL){
+    lineno++;
+    p=line;
+    while ((*p==' ')||(*p=='\t')) p++;
+    if ((*p=='#')||(*p=='\n')||(*p=='\r')||(*p=='\0')) continue;
+
+    scenarios=(scenario_t*)realloc(scenarios,(NUM_SCENARIOS+1)*sizeof(scenario_t));
+    sc=&scenarios[NUM_SCENARIOS];
+    memset(sc,0,sizeof(scenario_t));
+    sc->use_mode=USE_MODE;
+    sc->num_uses=NUM_USES;
+    sc->flush_mode=FLUSH_MODE;
+    sc->num_flushes=NUM_FLUSHES;
+    sc->flush_levels[0]=FLUSH_L1;sc->flush_levels[1]=FLUSH_L2;sc->flush_levels[2]=FLUSH_L3;sc->flush_levels[3]=FLUSH_L4;
+    sc->alignment=ALIGNMENT;
+    sc->threads=(int*)malloc(NUM_RESULTS*sizeof(int));
+    sc->measured=(unsigned char*)calloc(NUM_RESULTS,sizeof(unsigned char));
+    for (t=0;t<NUM_RESULTS;t++) {sc->threads[t]=t;sc->measured[t]=1;}
+    sc->num_threads=NUM_RESULTS;
+    NUM_SCENARIOS++;
+
+    /* split the line into words */
+    i=0;
+    do{
+      q=p;
+      while ((*q!=' ')&&(*q!='\t')&&(*q!='\n')&&(*q!='\r')&&(*q!='\0')) q++;
+      if (*q!='\0') {*q='\0';q++;}
+      while ((*q==' ')||(*q=='\t')||(*q=='\n')||(*q=='\r')) q++;
+      if (*q=='\0') q=NULL;
+
+      if (i==0){
+        if (snprintf(sc->name,sizeof(sc->name),"%s",p)>=(int)sizeof(sc->name)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SCENARIO_FILE line %i: scenario name longer than %i characters",lineno,(int)sizeof(sc->name)-1);}
+        i++;p=q;continue;
+      }
+      value=strstr(p,"=");
+      if (value==NULL) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SCENARIO_FILE line %i: expected KEY=VALUE instead of %s",lineno,p);p=q;continue;}
+      *value='\0';value++;
+      if (!strcmp(p,"USE_MODE")) {sc->use_mode=parse_use_mode(value);if (sc->use_mode<0) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SCENARIO_FILE line %i: invalid USE_MODE",lineno);}}
+      else if (!strcmp(p,"USE_ACCESSES")) sc->num_uses=atoi(value);
+      else if (!strcmp(p,"FLUSH_MODE")) {sc->flush_mode=parse_flush_mode(value);if (sc->flush_mode<0) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SCENARIO_FILE line %i: invalid FLUSH_MODE",lineno);}}
+      else if (!strcmp(p,"FLUSH_ACCESSES")) sc->num_flushes=atoi(value);
+      else if (!strcmp(p,"FLUSH_L1")) sc->flush_levels[0]=atoi(value);
+      else if (!strcmp(p,"FLUSH_L2")) sc->flush_levels[1]=atoi(value);
+      else if (!strcmp(p,"FLUSH_L3")) sc->flush_levels[2]=atoi(value);
+      else if (!strcmp(p,"FLUSH_L4")) sc->flush_levels[3]=atoi(value);
+      else if (!strcmp(p,"ALIGNMENT")) {sc->alignment=atoi(value);if (sc->alignment<1) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SCENARIO_FILE line %i: invalid ALIGNMENT",lineno);}}
+      else if (!strcmp(p,"CPU_LIST")){
+        /* each CPU is mapped to a thread that is not used by the scenario yet, so CPUs can be listed multiple times */
+        memset(sc->measured,0,NUM_RESULTS*sizeof(unsigned char));
+        sc->num_threads=0;
+        do{
+          r=strstr(value,",");if (r) {*r='\0';r++;}
+          cpu=atoi(value);
+          if (sc->num_threads==0) t=((unsigned long long)cpu==cpu_bind[0])?0:NUM_RESULTS;
+          else for (t=1;t<NUM_RESULTS;t++) if ((!sc->measured[t])&&(cpu_bind[t]==(unsigned long long)cpu)) break;
+          if (t==NUM_RESULTS) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SCENARIO_FILE line %i: CPU %i is not available in BENCHIT_KERNEL_CPU_LIST (the first CPU has to be CPU %llu)",lineno,cpu,cpu_bind[0]);}
+          else {sc->measured[t]=1;sc->threads[sc->num_threads++]=t;}
+          value=r;
+        }while(value!=NULL);
+      }
+      else {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SCENARIO_FILE line %i: unknown setting %s",lineno,p);}
+      p=q;
+    }while(p!=NULL);
+
+    if ((sc->use_mode==MODE_SHARED)||(sc->use_mode==MODE_OWNED)||(sc->use_mode==MODE_FORWARD)||(sc->use_mode==MODE_MUW)) SCENARIO_SHARED=1;
+  }
+  fclose(f);
+
+  if (NUM_SCENARIOS==0) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SCENARIO_FILE %s contains no scenarios",file);}
+  return errors;
+}
+
+/** enables the flushes of the selected cache levels that are available
+ *  @return FLUSH() bits
+ */
+static unsigned int flush_settings(volatile mydata_t *mdp, int *levels)
+{
+  unsigned int settings=0;
+  int l;
+
+  for (l=0;l<4;l++){
+    if ((levels[l])&&(mdp->cpuinfo->U_Cache_Size[l]+mdp->cpuinfo->D_Cache_Size[l]!=0)){
+      settings|=FLUSH(l+1);
+      if (mdp->cpuinfo->Cacheline_size[l]==0){
+        fprintf( stderr, "Error: unknown Cacheline-length for L%i cache\n",l+1 );
+        exit( 1 );
+      }
+    }
+  }
+  return settings;
+}
+
+/** switches all threads to the settings of scenario sc
+ */
+void apply_scenario(volatile mydata_t *mdp, scenario_t *sc)
+{
+  int t;
+
+  mdp->USE_MODE=sc->use_mode;
+  mdp->NUM_USES=sc->num_uses;
+  mdp->FLUSH_MODE=sc->flush_mode;
+  mdp->NUM_FLUSHES=sc->num_flushes;
+  mdp->settings=(mdp->settings&~(FLUSH(1)|FLUSH(2)|FLUSH(3)|FLUSH(4)))|sc->flush_settings;
+  for (t=0;t<mdp->num_threads;t++){
+    mdp->threaddata[t].USE_MODE=sc->use_mode;
+    mdp->threaddata[t].NUM_USES=sc->num_uses;
+    mdp->threaddata[t].FLUSH_MODE=sc->flush_mode;
+    mdp->threaddata[t].NUM_FLUSHES=sc->num_flushes;
+    mdp->threaddata[t].settings=mdp->settings;
+  }
+  set_measured_threads(sc->measured);
+}
+
 /** function that parses the PARAMETERS file
  */
 void evaluate_environment(bi_info * info);
@@ -134,12 +840,13 @@ void evaluate_environment(bi_info * info);
 void bi_getinfo( bi_info * infostruct )
 {
    int i = 0, j = 0; /* loop var for n_of_works */
-   char buff[512];
+   char buff[512],readers[64],sweep[128];
    (void) memset ( infostruct, 0, sizeof( bi_info ) );
    /* get environment variables for the kernel */
    evaluate_environment(infostruct);
    infostruct->codesequence = bi_strdup( CODE_SEQUENCE );
-   infostruct->xaxistext = bi_strdup( X_AXIS_TEXT );
+   if (WAKEUP_MODE) infostruct->xaxistext = bi_strdup( X_AXIS_TEXT_WAKEUP );
+   else infostruct->xaxistext = bi_strdup( X_AXIS_TEXT );
    infostruct->base_xaxis=10.0;
    infostruct->maxproblemsize=problemlistsize;
    sprintf(buff, KERNEL_DESCRIPTION);
@@ -157,9 +864,17 @@ void bi_getinfo( bi_info * infostruct )
    #ifdef USE_PAPI
     n_of_works+=papi_num_counters;
    #endif
+   /* number of rejected runs */
+   if (NOISE_REJECTION) n_of_works++;
+   /* first-touch duration per GiB */
+   if (PAGE_FAULT_MODE) n_of_works++;
+   /* 90th and 99th percentile and maximum of the wake-up latency */
+   if (WAKEUP_MODE) n_of_works+=3;
       
    /* measure local latency of CPU0 and latency between CPU0 and all other selected CPUs*/
-   n_of_sure_funcs_per_work = NUM_RESULTS;
+   /* sharer scaling: measure latency of CPU0 accessing lines shared by 1 to NUM_RESULTS-1 CPUs */
+   /* scenarios: the selected CPUs of all scenarios one after another */
+   n_of_sure_funcs_per_work = NUM_COLUMNS;
    
    infostruct->numfunctions = n_of_works * n_of_sure_funcs_per_work;
 
@@ -186,39 +901,92 @@ void bi_getinfo( bi_info * infostruct )
    }
 
    /* setting up y axis texts and properties */
+   if (CONCURRENT_READERS) sprintf(readers,", %i concurrent readers",CONCURRENT_READERS);
+   else readers[0]='\0';
+   /* local results of the sizes up to L2 are measured on the sweep CPUs instead of the first CPU */
+   sweep[0]='\0';
+   if (NUM_SWEEP_CPUS){
+     int n=sprintf(sweep,", sizes up to L2 on CPU");
+     for (i=NUM_THREADS-NUM_SWEEP_CPUS;(i<NUM_THREADS)&&(n<(int)sizeof(sweep));i++) n+=snprintf(sweep+n,sizeof(sweep)-n,"%s%llu",(i>NUM_THREADS-NUM_SWEEP_CPUS)?"/":"",cpu_bind[i]);
+   }
    for ( j = 0; j < n_of_works; j++ ){
-     int k,index;
-      for (k=0;k<n_of_sure_funcs_per_work;k++)
+     int c,k,index;
+      for (c=0;c<n_of_sure_funcs_per_work;c++)
       {
-
-        index= k + n_of_sure_funcs_per_work * j;
+        k=column_thread[c];
+        index= c + n_of_sure_funcs_per_work * j;
         infostruct->base_yaxis[index] = 0;
         switch ( j )
         {
           case 1: // ns
-            if (k)  sprintf(buff,"memory latency CPU%llu accessing CPU%llu memory (time)",cpu_bind[0],cpu_bind[k]);
-            else sprintf(buff,"memory latency CPU%llu locally (time)",cpu_bind[0]);
+            if ((WAKEUP_MODE)&&(k)) sprintf(buff,"wake-up latency CPU%llu%s -> CPU%llu%s, %s, median (time)",cpu_bind[0],core_type(cpu_bind[0]),cpu_bind[k],core_type(cpu_bind[k]),WAKEUP_NAME);
+            else if (WAKEUP_MODE) sprintf(buff,"wake-up latency CPU%llu, source (time)",cpu_bind[0]);
+            else if (PAGE_FAULT_MODE) sprintf(buff,"first touch latency CPU%llu, %s (time per page)",cpu_bind[k],PAGE_FAULT_NAME);
+            else if (CODE_LATENCY) sprintf(buff,"instruction fetch latency CPU%llu, %s pages (time)",cpu_bind[k],CODE_LATENCY_NAME);
+            else if ((k)&&(SHARER_SCALING)) sprintf(buff,"memory latency CPU%llu accessing lines shared by %i CPUs%s (time)",cpu_bind[0],k,readers);
+            else if (k)  sprintf(buff,"memory latency CPU%llu accessing CPU%llu memory (time)",cpu_bind[0],cpu_bind[k]);
+            else sprintf(buff,"memory latency CPU%llu locally%s (time)",cpu_bind[0],sweep);
             infostruct->legendtexts[index] = bi_strdup( buff );
             infostruct->outlier_direction_upwards[index] = 1;  //report minimum of iterations
             infostruct->yaxistexts[index] = bi_strdup( Y_AXIS_TEXT_1 );
             break;
           case 0: // cycles
-           if (k)  sprintf(buff,"memory latency CPU%llu accessing CPU%llu memory (CPU cycles)",cpu_bind[0],cpu_bind[k]);
-           else sprintf(buff,"memory latency CPU%llu locally (CPU cycles)",cpu_bind[0]);
+           if ((WAKEUP_MODE)&&(k)) sprintf(buff,"wake-up latency CPU%llu%s -> CPU%llu%s, %s, median (CPU cycles)",cpu_bind[0],core_type(cpu_bind[0]),cpu_bind[k],core_type(cpu_bind[k]),WAKEUP_NAME);
+           else if (WAKEUP_MODE) sprintf(buff,"wake-up latency CPU%llu, source (CPU cycles)",cpu_bind[0]);
+           else if (PAGE_FAULT_MODE) sprintf(buff,"first touch latency CPU%llu, %s (CPU cycles per page)",cpu_bind[k],PAGE_FAULT_NAME);
+           else if (CODE_LATENCY) sprintf(buff,"instruction fetch latency CPU%llu, %s pages (CPU cycles)",cpu_bind[k],CODE_LATENCY_NAME);
+           else if ((k)&&(SHARER_SCALING)) sprintf(buff,"memory latency CPU%llu accessing lines shared by %i CPUs%s (CPU cycles)",cpu_bind[0],k,readers);
+           else if (k)  sprintf(buff,"memory latency CPU%llu accessing CPU%llu memory (CPU cycles)",cpu_bind[0],cpu_bind[k]);
+           else sprintf(buff,"memory latency CPU%llu locally%s (CPU cycles)",cpu_bind[0],sweep);
            infostruct->legendtexts[index] = bi_strdup( buff );
            infostruct->outlier_direction_upwards[index] = 1;   //report minimum of iterations
            infostruct->yaxistexts[index] = bi_strdup( Y_AXIS_TEXT_2 );
            break;
           default: // papi
            #ifdef USE_PAPI
-            if (k)  sprintf(buff,"%s CPU%llu - CPU%llu",papi_names[j-2],cpu_bind[0],cpu_bind[k]);
+           if (j-2<papi_num_counters){
+            if ((k)&&(SHARER_SCALING)) sprintf(buff,"%s CPU%llu - %i sharers%s",papi_names[j-2],cpu_bind[0],k,readers);
+            else if (k)  sprintf(buff,"%s CPU%llu - CPU%llu",papi_names[j-2],cpu_bind[0],cpu_bind[k]);
             else sprintf(buff,"%s CPU%llu locally",papi_names[j-2],cpu_bind[0]);
             infostruct->legendtexts[index] = bi_strdup( buff );
             infostruct->outlier_direction_upwards[index] = 0;  //report maximum of iterations
             infostruct->yaxistexts[index] = bi_strdup( Y_AXIS_TEXT_3 );
+            break;
+           }
            #endif
+           // first-touch duration per GiB, follows the rejected runs
+           if ((PAGE_FAULT_MODE)&&(j==n_of_works-1)){
+            sprintf(buff,"first touch CPU%llu, %s (time per GiB)",cpu_bind[k],PAGE_FAULT_NAME);
+            infostruct->legendtexts[index] = bi_strdup( buff );
+            infostruct->outlier_direction_upwards[index] = 1;  //report minimum of iterations
+            infostruct->yaxistexts[index] = bi_strdup( Y_AXIS_TEXT_5 );
+            break;
+           }
+           // percentiles of the wake-up latency
+           if ((WAKEUP_MODE)&&(j>=n_of_works-3)){
+            char *percentile[3]={"90th percentile","99th percentile","maximum"};
+            if (k) sprintf(buff,"wake-up latency CPU%llu%s -> CPU%llu%s, %s, %s (time)",cpu_bind[0],core_type(cpu_bind[0]),cpu_bind[k],core_type(cpu_bind[k]),WAKEUP_NAME,percentile[j-(n_of_works-3)]);
+            else sprintf(buff,"wake-up latency CPU%llu, source, %s (time)",cpu_bind[0],percentile[j-(n_of_works-3)]);
+            infostruct->legendtexts[index] = bi_strdup( buff );
+            infostruct->outlier_direction_upwards[index] = 1;  //report minimum of iterations
+            infostruct->yaxistexts[index] = bi_strdup( Y_AXIS_TEXT_1 );
+            break;
+           }
+           // rejected runs
+           if ((k)&&(SHARER_SCALING)) sprintf(buff,"rejected runs CPU%llu - %i sharers%s",cpu_bind[0],k,readers);
+           else if (k)  sprintf(buff,"rejected runs CPU%llu - CPU%llu",cpu_bind[0],cpu_bind[k]);
+           else sprintf(buff,"rejected runs CPU%llu locally",cpu_bind[0]);
+           infostruct->legendtexts[index] = bi_strdup( buff );
+           infostruct->outlier_direction_upwards[index] = 0;  //report maximum of iterations
+           infostruct->yaxistexts[index] = bi_strdup( Y_AXIS_TEXT_4 );
            break;
         } 
+        /* results are tagged with the name of the scenario */
+        if (NUM_SCENARIOS){
+          sprintf(buff,"%s: %s",scenarios[column_scenario[c]].name,infostruct->legendtexts[index]);
+          free(infostruct->legendtexts[index]);
+          infostruct->legendtexts[index] = bi_strdup( buff );
+        }
       }
    }
 }
@@ -242,7 +1010,9 @@ void* bi_init( int problemsizemax )
    
    //TODO replace unsigned long long with max data type size ???
    /* increase buffersize to account for alignment and offsets */
-   BUFFERSIZE=sizeof(char)*(MAX+ALIGNMENT+OFFSET+2*sizeof(unsigned long long));
+   tmp=ALIGNMENT;
+   for (j=0;j<NUM_SCENARIOS;j++) if ((unsigned long long)scenarios[j].alignment>tmp) tmp=scenarios[j].alignment;
+   BUFFERSIZE=sizeof(char)*(MAX+tmp+OFFSET+2*sizeof(unsigned long long));
 
    /* if hugepages are enabled increase buffersize to the smallest multiple of 2 MIB greater than buffersize */
    if (HUGEPAGES==HUGEPAGES_ON) BUFFERSIZE=(BUFFERSIZE+(2*1024*1024))&0xffe00000ULL;
@@ -319,12 +1089,86 @@ void* bi_init( int problemsizemax )
    mdp->FRST_SHARE_CPU=FRST_SHARE_CPU;
    mdp->NUM_SHARED_CPUS=NUM_SHARED_CPUS;
    mdp->hugepages=HUGEPAGES;
+   mdp->NOISE_REJECTION=NOISE_REJECTION;
+   mdp->NOISE_RETRIES=NOISE_RETRIES;
+   mdp->SCHED_PRIO=SCHED_PRIO;
+   mdp->SHARER_SCALING=SHARER_SCALING;
+   mdp->CONCURRENT_READERS=CONCURRENT_READERS;
+   mdp->LAZY_INIT=LAZY_INIT;
+   mdp->PAGE_FAULT_MODE=PAGE_FAULT_MODE;
+   mdp->PROCESS_MODE=PROCESS_MODE;
+   mdp->CODE_LATENCY=CODE_LATENCY;
+   mdp->NUM_SWEEP_CPUS=NUM_SWEEP_CPUS;
+   mdp->start=0;
    if (LOOP_OVERHEAD_COMPENSATION){
      mdp->settings|=LOOP_OVERHEAD_COMP;
      mdp->loop_overhead=LOOP_OVERHEAD_COMPENSATION;
    }
 
    if (ALWAYS_FLUSH_CPU0) mdp->settings|=OPT_FLUSH_CPU0;
+   /* conflict sets are only used for inclusive caches, see flush_caches() */
+   if (FLUSH_TARGETED){
+     if (!strcmp(mdp->cpuinfo->vendor,"AuthenticAMD")) {fprintf( stderr, "Warning: BENCHIT_KERNEL_FLUSH_TARGETED not supported on AMD CPUs, using flush areas\n" ); fflush( stderr );}
+     else mdp->settings|=TARGETED_EVICTION;
+   }
+   if (VERIFY_PLACEMENT_MODE) mdp->settings|=VERIFY_PLACEMENT;
+   if (VERIFY_PLACEMENT_MODE==2) mdp->settings|=REJECT_MISPLACED;
+   set_chain_options(CHAIN_SEED,CHAIN_CACHE_DIR);
+
+   if (DRAM_SOLVE) dram_solver();
+   if ((DRAM_MODE)&&(DRAM_NUM_FUNCTIONS==0)){
+     fprintf( stderr, "Error: no DRAM bank functions for BENCHIT_KERNEL_DRAM_MODE\n" ); fflush( stderr );
+     exit( 127 );
+   }
+   set_dram_options(DRAM_MODE,DRAM_FUNCTIONS,DRAM_NUM_FUNCTIONS,DRAM_ROW_SHIFT);
+   set_structure_options(STRUCTURE);
+
+   if (WAKEUP_MODE){
+     wakeup_percentiles=(double*)malloc(3*NUM_RESULTS*sizeof(double));
+     if (wakeup_percentiles==NULL){
+       fprintf( stderr, "Error: Allocation of structure wakeup_percentiles failed\n" ); fflush( stderr );
+       exit( 127 );
+     }
+   }
+   set_wakeup_options(WAKEUP_MODE,WAKEUP_SAMPLES,wakeup_percentiles);
+
+   if (FENCE_COST) for_each_cpu(mdp,fence_cost);
+   if (PREFETCH_ADVISOR) for_each_cpu(mdp,prefetch_advisor);
+   if (STORE_FORWARDING) for_each_cpu(mdp,store_forwarding);
+   if (INTERLEAVED_LOOKUPS) for_each_cpu(mdp,interleaved_lookups);
+   if (VICTIM_PATH) for_each_cpu(mdp,victim_path);
+
+   if (PLATEAU_ANALYSIS){
+     plateau_sizes=(double*)calloc(problemlistsize,sizeof(double));
+     plateau_cycles=(double*)calloc(problemlistsize*NUM_RESULTS,sizeof(double));
+     if ((plateau_sizes==NULL)||(plateau_cycles==NULL)){
+       fprintf( stderr, "Error: Allocation of structure mydata_t failed\n" ); fflush( stderr );
+       exit( 127 );
+     }
+   }
+
+   /* sizes up to L2 are measured on the sweep CPUs */
+   if (NUM_SWEEP_CPUS){
+     SWEEP_MAX=mdp->cpuinfo->U_Cache_Size[1]+mdp->cpuinfo->D_Cache_Size[1];
+     if (SWEEP_MAX==0) {
+       fprintf( stderr, "Warning: unknown L2 size, BENCHIT_KERNEL_SWEEP_CPU_LIST ignored\n" ); fflush(stderr);
+     }
+     sweep_results=(double*)calloc(problemlistsize,sizeof(double));
+     sweep_index=(int*)malloc(NUM_SWEEP_CPUS*sizeof(int));
+     if ((sweep_results==NULL)||(sweep_index==NULL)){
+       fprintf( stderr, "Error: Allocation of structure mydata_t failed\n" ); fflush( stderr );
+       exit( 127 );
+     }
+   }
+
+   /* the L1 and L2 loads use half of the cache (the other half is left to the measuring CPU), the DRAM load 4 times the total cache size */
+   if (SMT_LOAD==SMT_LOAD_L1) SMT_LOAD_SIZE=(mdp->cpuinfo->U_Cache_Size[0]+mdp->cpuinfo->D_Cache_Size[0])/2;
+   if (SMT_LOAD==SMT_LOAD_L2) SMT_LOAD_SIZE=(mdp->cpuinfo->U_Cache_Size[1]+mdp->cpuinfo->D_Cache_Size[1])/2;
+   if (SMT_LOAD==SMT_LOAD_DRAM) SMT_LOAD_SIZE=4*mdp->cpuinfo->Total_D_Cache_Size;
+   if ((SMT_LOAD!=SMT_LOAD_OFF)&&(SMT_LOAD!=SMT_LOAD_ALU)&&(SMT_LOAD_SIZE==0)){
+     fprintf( stderr, "Error: unknown cache size, BENCHIT_KERNEL_SMT_LOAD=%s not possible\n",SMT_LOAD_NAME ); fflush( stderr );
+     exit( 127 );
+   }
 
    /** pagesize is needed for the TLB optimisation, which is only used if hugepages are not available. */
    mdp->pagesize=mdp->cpuinfo->pagesizes[0];
@@ -360,34 +1204,11 @@ void* bi_init( int problemsizemax )
    }   
 
    /* enable selected cache flushes */
-   if ((FLUSH_L1)&&(mdp->cpuinfo->U_Cache_Size[0]+mdp->cpuinfo->D_Cache_Size[0]!=0)){ 
-      mdp->settings|=FLUSH(1);
-      if (mdp->cpuinfo->Cacheline_size[0]==0){
-        fprintf( stderr, "Error: unknown Cacheline-length for L1 cache\n" );
-        exit( 1 );    
-      }     
-   }
-   if ((FLUSH_L2)&&(mdp->cpuinfo->U_Cache_Size[1]+mdp->cpuinfo->D_Cache_Size[1]!=0)){
-      mdp->settings|=FLUSH(2);
-      if (mdp->cpuinfo->Cacheline_size[1]==0){
-        fprintf( stderr, "Error: unknown Cacheline-length for L2 cache\n" );
-        exit( 1 );    
-      }     
-   }
-   if ((FLUSH_L3)&&(mdp->cpuinfo->U_Cache_Size[2]+mdp->cpuinfo->D_Cache_Size[2]!=0)){ 
-      mdp->settings|=FLUSH(3);
-      if (mdp->cpuinfo->Cacheline_size[2]==0){
-        fprintf( stderr, "Error: unknown Cacheline-length for L3 cache\n" );
-        exit( 1 );    
-      }     
-   }
-   if ((FLUSH_L4)&&(mdp->cpuinfo->U_Cache_Size[3]+mdp->cpuinfo->D_Cache_Size[3]!=0)){ 
-      mdp->settings|=FLUSH(4);
-      if (mdp->cpuinfo->Cacheline_size[3]==0){
-        fprintf( stderr, "Error: unknown Cacheline-length for L4 cache\n" );
-        exit( 1 );    
-      }     
+   {
+      int levels[4]={FLUSH_L1,FLUSH_L2,FLUSH_L3,FLUSH_L4};
+      mdp->settings|=flush_settings(mdp,levels);
    }
+   for (j=0;j<NUM_SCENARIOS;j++) scenarios[j].flush_settings=flush_settings(mdp,scenarios[j].flush_levels);
    mdp->flush_share_cpu=(unsigned char)FLUSH_SHARED_CPU;
    printf("\n");     
    if (mdp->settings&FLUSH(1)) printf("  enabled L1 flushes\n");
@@ -424,6 +1245,62 @@ void* bi_init( int problemsizemax )
 
    mdp->threaddata = _mm_malloc(mdp->num_threads*sizeof(threaddata_t),ALIGNMENT);
    memset( mdp->threaddata,0,mdp->num_threads*sizeof(threaddata_t));
+   mdp->threaddata[0].cpu_id=cpu_bind[0];
+   mdp->threaddata[0].mem_bind=mem_bind[0];
+   if (NOISE_REJECTION){
+     mdp->noise_results=(double*)malloc(mdp->num_threads*sizeof(double));
+     if (mdp->noise_results==NULL){
+       fprintf( stderr, "Error: Allocation of structure mydata_t failed\n" ); fflush( stderr );
+       exit( 127 );
+     }
+   }
+   if (PAGE_FAULT_MODE){
+     mdp->fault_results=(double*)malloc(mdp->num_threads*sizeof(double));
+     if (mdp->fault_results==NULL){
+       fprintf( stderr, "Error: Allocation of structure mydata_t failed\n" ); fflush( stderr );
+       exit( 127 );
+     }
+   }
+   if (SAMPLE_DURATION){
+     sample_file_header_t header;
+
+     mdp->sampling=(sampling_t*)malloc(sizeof(sampling_t));
+     if (mdp->sampling==NULL){
+       fprintf( stderr, "Error: Allocation of structure mydata_t failed\n" ); fflush( stderr );
+       exit( 127 );
+     }
+     memset(mdp->sampling,0,sizeof(sampling_t));
+     mdp->sampling->duration=(unsigned long long)SAMPLE_DURATION*mdp->cpuinfo->clockrate;
+     mdp->sampling->max_samples=SAMPLE_MAX;
+     mdp->sampling->passes=SAMPLE_PASSES;
+     mdp->sampling->segments=(unsigned long long*)malloc((ACCESSES/(24*SAMPLE_PASSES)+1)*sizeof(unsigned long long));
+     /* touch the sample buffer, page faults during the sampling would show up in the time series */
+     mdp->sampling->samples=(sample_t*)_mm_malloc(SAMPLE_MAX*sizeof(sample_t),ALIGNMENT);
+     if ((mdp->sampling->segments==NULL)||(mdp->sampling->samples==NULL)){
+       fprintf( stderr, "Error: Allocation of sample buffer failed\n" ); fflush( stderr );
+       exit( 127 );
+     }
+     memset(mdp->sampling->samples,0,SAMPLE_MAX*sizeof(sample_t));
+
+     mdp->sampling->fd=open(SAMPLE_FILE,O_CREAT|O_WRONLY|O_TRUNC,0664);
+     if (mdp->sampling->fd==-1){
+       fprintf( stderr, "Error: could not create sample file %s\n",SAMPLE_FILE ); fflush( stderr );
+       perror("open");
+       exit( 127 );
+     }
+     memset(&header,0,sizeof(header));
+     memcpy(header.magic,"BILATSMP",8);
+     header.version=1;
+     header.record_size=sizeof(sample_t);
+     header.clockrate=mdp->cpuinfo->clockrate;
+     header.memsize=SAMPLE_SIZE;
+     header.use_mode=USE_MODE;
+     header.accesses=24*SAMPLE_PASSES;
+     if (write(mdp->sampling->fd,&header,sizeof(header))!=sizeof(header)){
+       fprintf( stderr, "Error: could not write sample file %s\n",SAMPLE_FILE ); fflush( stderr );
+       exit( 127 );
+     }
+   }
   #ifdef USE_PAPI
    mdp->Eventset=EventSet;
    mdp->num_events=papi_num_counters;
@@ -461,7 +1338,8 @@ void* bi_init( int problemsizemax )
     mdp->threaddata[t].data=mdp;
     mdp->thread_comm[t]=THREAD_INIT;
     mdp->threaddata[t].settings=mdp->settings;
-    if (GLOBAL_FLUSH_BUFFER){
+    /* sweep CPUs run concurrently to the measuring CPU and always use their own flush buffer */
+    if ((GLOBAL_FLUSH_BUFFER)&&(t<mdp->num_threads-NUM_SWEEP_CPUS)){
        mdp->threaddata[t].cache_flush_area=mdp->cache_flush_area;
     }
     else {
@@ -486,6 +1364,10 @@ void* bi_init( int problemsizemax )
     mdp->threaddata[t].NUM_FLUSHES=mdp->NUM_FLUSHES;
     mdp->threaddata[t].FLUSH_MODE=mdp->FLUSH_MODE;
     mdp->threaddata[t].buffersize=BUFFERSIZE;
+    if ((SWEEP_MAX)&&(t>=mdp->num_threads-NUM_SWEEP_CPUS)){
+      mdp->threaddata[t].buffersize=sizeof(char)*(SWEEP_MAX+ALIGNMENT+OFFSET+2*sizeof(unsigned long long));
+      if (HUGEPAGES==HUGEPAGES_ON) mdp->threaddata[t].buffersize=(mdp->threaddata[t].buffersize+(2*1024*1024))&0xffe00000ULL;
+    }
     mdp->threaddata[t].alignment=mdp->cpuinfo->pagesizes[0];
     mdp->threaddata[t].offset=OFFSET;    
     pthread_create(&(mdp->threads[t]),NULL,thread,(void*)(&(mdp->threaddata[t])));
@@ -503,7 +1385,8 @@ void* bi_init( int problemsizemax )
  
   /* allocate memory for first thread */
   //printf("first thread, malloc: %llu \n",BUFFERSIZE);
-  if (HUGEPAGES==HUGEPAGES_OFF) mdp->buffer = _mm_malloc( BUFFERSIZE,ALIGNMENT );
+  if ((HUGEPAGES==HUGEPAGES_OFF)&&(PROCESS_MODE)) mdp->buffer = alloc_shared_buffer(BUFFERSIZE);
+  else if (HUGEPAGES==HUGEPAGES_OFF) mdp->buffer = _mm_malloc( BUFFERSIZE,ALIGNMENT );
   if (HUGEPAGES==HUGEPAGES_ON){
      char *dir;
      dir=bi_getenv("BENCHIT_KERNEL_HUGEPAGE_DIR",0);
@@ -516,7 +1399,8 @@ void* bi_init( int problemsizemax )
        perror("open");
        exit( 127 );
      } 
-     mdp->buffer=(char*) mmap(NULL,BUFFERSIZE,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+     if (LAZY_INIT) mdp->buffer=(char*) mmap(NULL,BUFFERSIZE,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_NORESERVE,fd,0);
+     else mdp->buffer=(char*) mmap(NULL,BUFFERSIZE,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
      close(fd);unlink(filename);
   } 
   if ((mdp->buffer == 0)||(mdp->buffer == (void*) -1ULL)){
@@ -525,12 +1409,10 @@ void* bi_init( int problemsizemax )
      exit( 127 );
   }
  
-   /* initialize buffer */
-   tmp=sizeof(unsigned long long);
-   for (i=0;i<=BUFFERSIZE-tmp;i+=tmp){
-      *((unsigned long long*)((unsigned long long)mdp->buffer+i))=(unsigned long long)i;
-   }
-   clflush(mdp->buffer,BUFFERSIZE,*(mdp->cpuinfo));
+   /* initialize buffer, postponed to the first use if BENCHIT_KERNEL_LAZY_INIT is set */
+   mdp->threaddata[0].buffersize=BUFFERSIZE;
+   mdp->threaddata[0].initialized=0;
+   if (!LAZY_INIT) init_buffer(mdp->buffer,BUFFERSIZE,&(mdp->threaddata[0].initialized),BUFFERSIZE,mdp->cpuinfo);
  
   cpu_set(cpu_bind[0]);
   printf("  wait for threads memory initialization \n");fflush(stdout);
@@ -542,9 +1424,59 @@ void* bi_init( int problemsizemax )
   }
   mdp->ack=0;
   printf("    ...done\n");
+
+  /* helper processes inherit the buffers, so they are created after the threads allocated them */
+  if (PROCESS_MODE){
+    mdp->helpers=(helper_t*)malloc(mdp->num_threads*sizeof(helper_t));
+    if (mdp->helpers==NULL){
+      fprintf( stderr, "Error: Allocation of structure mydata_t failed\n" ); fflush( stderr );
+      exit( 127 );
+    }
+    memset(mdp->helpers,0,mdp->num_threads*sizeof(helper_t));
+    start_helper_processes(mdp);
+    printf("  data placement of CPUs %llu",cpu_bind[1]);
+    for (t=2;t<NUM_THREADS;t++) printf(",%llu",cpu_bind[t]);
+    printf(" is performed by helper processes\n");
+  }
+  if (LAZY_INIT) printf("  buffers are initialized on first use\n");
+  if (mdp->settings&TARGETED_EVICTION) printf("  L1 and L2 flushes evict the lines of the pointer chains using conflict sets\n");
+  if (DRAM_MODE){
+    printf("  pointer chains follow the DRAM address mapping (%s), row bits from %i, bank functions",DRAM_MODE_NAME,DRAM_ROW_SHIFT);
+    for (i=0;i<(unsigned long long)DRAM_NUM_FUNCTIONS;i++) printf(" 0x%llx",DRAM_FUNCTIONS[i]);
+    printf("\n");
+  }
+  if (STRUCTURE){
+    if (STRUCTURE<=STRUCTURE_BTREE_512) printf("  pointer chains emulate B-tree nodes (%s), latencies are reported per node\n",STRUCTURE_NAME);
+    else if (STRUCTURE==STRUCTURE_HASH_OPEN) printf("  pointer chains emulate lookups in a hash table with linear probing, latencies are reported per lookup\n");
+    else if (STRUCTURE==STRUCTURE_HASH_CHAINED) printf("  pointer chains emulate lookups in a hash table with chained buckets, latencies are reported per lookup\n");
+    else printf("  pointer chains emulate search tree levels (%s), latencies are reported per level\n",STRUCTURE==STRUCTURE_TREE_AOS?"array of structures":"structure of arrays");
+  }
+  if (CHAIN_SEED) printf("  random pointer chains use seed %llu\n",CHAIN_SEED);
+  if (CHAIN_CACHE_DIR) printf("  pointer chains are cached in %s\n",CHAIN_CACHE_DIR);
+  /* lazily initialized buffers have no pages yet, they are checked for each data set size */
+  if ((VERIFY_PLACEMENT_MODE)&&(!LAZY_INIT)) report_placement(mdp);
+  if (PAGE_FAULT_MODE) printf("  measuring first touch latency (%s) instead of memory latency\n",PAGE_FAULT_NAME);
+  if (WAKEUP_MODE) printf("  measuring wake-up latency (%s, %i samples) instead of memory latency, problem sizes are idle periods in ns\n",WAKEUP_NAME,WAKEUP_SAMPLES);
+  if (CODE_LATENCY) printf("  measuring instruction fetch latency (%s pages) instead of memory latency\n",CODE_LATENCY_NAME);
+  if (SWEEP_MAX) printf("  local latency of sizes up to %llu Byte is measured concurrently on %i sweep CPUs\n",SWEEP_MAX,NUM_SWEEP_CPUS);
+  if (SAMPLE_DURATION) printf("  sampling %llu Byte for %i s per CPU, %i accesses per sample, writing to %s\n",SAMPLE_SIZE,SAMPLE_DURATION,24*SAMPLE_PASSES,SAMPLE_FILE);
   if ((num_packages()!=-1)&&(num_cores_per_package()!=-1)&&(num_threads_per_core()!=-1))  printf("  num_packages: %i, %i cores per package, %i threads per core\n",num_packages(),num_cores_per_package(),num_threads_per_core());
   printf("  using %i threads\n",NUM_THREADS);
   for (i=0;i<NUM_THREADS;i++) if ((get_pkg(cpu_bind[i])!=-1)&&(get_core_id(cpu_bind[i])!=-1)) printf("    - Thread %llu runs on CPU %llu, core %i in package: %i\n",i,cpu_bind[i],get_core_id(cpu_bind[i]),get_pkg(cpu_bind[i]));
+  if (SHARER_SCALING) printf("  sharer scaling: CPU %llu reads lines shared by 1 to %i CPUs, %i concurrent readers\n",cpu_bind[0],NUM_RESULTS-1,CONCURRENT_READERS);
+  if (NUM_SCENARIOS){
+    int l;
+    printf("  %i scenarios from %s:\n",NUM_SCENARIOS,SCENARIO_FILE);
+    for (j=0;j<NUM_SCENARIOS;j++){
+      printf("    - %s: USE_MODE %s, %i use accesses, FLUSH_MODE %s, %i flush accesses, flushes",scenarios[j].name,mode_name(scenarios[j].use_mode),scenarios[j].num_uses,
+             mode_name(scenarios[j].flush_mode),scenarios[j].num_flushes);
+      for (l=0;l<4;l++) if (scenarios[j].flush_settings&FLUSH(l+1)) printf(" L%i",l+1);
+      if (!(scenarios[j].flush_settings&(FLUSH(1)|FLUSH(2)|FLUSH(3)|FLUSH(4)))) printf(" none");
+      printf(", alignment %i, CPUs",scenarios[j].alignment);
+      for (l=0;l<scenarios[j].num_threads;l++) printf(" %llu",cpu_bind[scenarios[j].threads[l]]);
+      printf("\n");
+    }
+  }
   fflush(stdout);
 
 
@@ -552,6 +1484,28 @@ void* bi_init( int problemsizemax )
   watchdog_arg.pid=getpid();
   watchdog_arg.timeout=TIMEOUT;
   pthread_create(&watchdog,NULL,watchdog_timer,&watchdog_arg);
+
+  /* load on the SMT sibling, keeps SCHED_OTHER like the watchdog */
+  if (SMT_LOAD){
+    start_smt_load(SMT_CPU,SMT_LOAD,SMT_LOAD_SIZE);
+    printf("  %s load on SMT sibling CPU %i of CPU %llu",SMT_LOAD_NAME,SMT_CPU,cpu_bind[0]);
+    if (SMT_LOAD!=SMT_LOAD_ALU) printf(", reading %llu Byte",SMT_LOAD_SIZE);
+    printf("\n");fflush(stdout);
+  }
+
+  /* lock buffers in memory, done after the initialization as MCL_FUTURE would let allocations fail that exceed RLIMIT_MEMLOCK */
+  if (MLOCK_MEMORY){
+    if (mlockall(MCL_CURRENT)) {fprintf( stderr, "Warning: mlockall() failed, continuing without locked memory\n" );perror("mlockall");fflush( stderr );}
+    else {printf("  locked all buffers in memory\n");fflush(stdout);}
+  }
+
+  /* real-time priority for the measuring thread, the watchdog has already been created and keeps SCHED_OTHER */
+  if (SCHED_PRIO){
+    struct sched_param param;
+    param.sched_priority=SCHED_PRIO;
+    if (pthread_setschedparam(pthread_self(),SCHED_FIFO,&param)) {fprintf( stderr, "Warning: could not switch to SCHED_FIFO, continuing with default scheduler\n" ); fflush( stderr );}
+    else {printf("  using SCHED_FIFO with priority %i\n",SCHED_PRIO);fflush(stdout);}
+  }
   
   return (void*)mdp;
 }
@@ -571,7 +1525,7 @@ void* bi_init( int problemsizemax )
 int inline bi_entry( void* mdpv, int problemsize, double* results )
 {
   /* j is used for loop iterations */
-  int j = 0,k = 0;
+  int j = 0,k = 0,c,sc = 0,alignment = ALIGNMENT;
   /* real problemsize*/
   unsigned long long rps;
   /* cast void* pointer */
@@ -591,23 +1545,84 @@ int inline bi_entry( void* mdpv, int problemsize, double* results )
   /* check wether the pointer to store the results in is valid or not */
   if ( results == NULL ) return 1;
 
-  /* one call measures latencies in cycles for all selected CPUs */
-  _work(rps,ALIGNMENT,OFFSET,FUNCTION,ACCESSES,RUNS,mdp,&tmp_results);
+  /* one call measures latencies in cycles for all selected CPUs
+   * the local latency of sizes up to L2 is measured on the sweep CPUs while the master measures the other CPUs
+   * scenarios are measured one after another with the same threads and buffers */
+  do{
+  if (NUM_SCENARIOS){
+    apply_scenario(mdp,&scenarios[sc]);
+    alignment=scenarios[sc].alignment;
+  }
+  mdp->skip_local=0;
+  if ((SWEEP_MAX)&&(rps<=SWEEP_MAX)){
+    if (sweep_results[problemsize-1]==0){
+      /* current size and the following sizes up to L2 that are not measured yet, one per sweep CPU */
+      int first=mdp->num_threads-NUM_SWEEP_CPUS,t=first;
+      unsigned long long size,cycles;
+      for (j=problemsize-1;(j<problemlistsize)&&(t<mdp->num_threads);j++){
+        if (RANDOM) size=problemarray2[j];
+        else size=problemarray1[j];
+        if ((size>SWEEP_MAX)||(sweep_results[j]!=0)) continue;
+        sweep_index[t-first]=j;
+        start_sweep(mdp,t,size,ALIGNMENT,ACCESSES,RUNS);
+        t++;
+      }
+      mdp->skip_local=1;
+      _work(rps,ALIGNMENT,OFFSET,FUNCTION,ACCESSES,RUNS,mdp,&tmp_results);
+      for (k=first;k<t;k++){
+        cycles=finish_sweep(mdp,k);
+        if (cycles) sweep_results[sweep_index[k-first]]=(double)cycles;
+        else sweep_results[sweep_index[k-first]]=INVALID_MEASUREMENT;
+      }
+    }
+    else{
+      mdp->skip_local=1;
+      _work(rps,ALIGNMENT,OFFSET,FUNCTION,ACCESSES,RUNS,mdp,&tmp_results);
+    }
+    tmp_results[0]=sweep_results[problemsize-1];
+  }
+  else _work(rps,alignment,OFFSET,FUNCTION,ACCESSES,RUNS,mdp,&tmp_results);
   results[0] = (double)rps;
 
-  /* copy tmp_results to final results */  
-for (k=0;k<NUM_RESULTS;k++)
+  /* copy tmp_results to final results, the columns of the current scenario */  
+for (c=0;c<NUM_COLUMNS;c++)
   {
+    if (column_scenario[c]!=sc) continue;
+    k=column_thread[c];
     /* write measured cycles to final results, calculate duration*/
-    results[1+k]=tmp_results[k];
-    if (tmp_results[k]==INVALID_MEASUREMENT)results[1+NUM_RESULTS+k]=INVALID_MEASUREMENT;
-    else results[1+NUM_RESULTS+k]=(double)((tmp_results[k]/mdp->cpuinfo->clockrate)*1000000000);
+    results[1+c]=tmp_results[k];
+    if (tmp_results[k]==INVALID_MEASUREMENT)results[1+NUM_COLUMNS+c]=INVALID_MEASUREMENT;
+    else results[1+NUM_COLUMNS+c]=(double)((tmp_results[k]/mdp->cpuinfo->clockrate)*1000000000);
+    j=0;
     #ifdef USE_PAPI
     for (j=0;j<papi_num_counters;j++)
     {
-      results[1+(j+2)*NUM_RESULTS+k]=mdp->papi_results[j*NUM_RESULTS+k];
+      results[1+(j+2)*NUM_COLUMNS+c]=mdp->papi_results[j*NUM_RESULTS+k];
     }
     #endif
+    if (NOISE_REJECTION) {results[1+(j+2)*NUM_COLUMNS+c]=mdp->noise_results[k];j++;}
+    if (WAKEUP_MODE){
+      int l;
+      for (l=0;l<3;l++){
+        if (wakeup_percentiles[l*NUM_RESULTS+k]==INVALID_MEASUREMENT) results[1+(j+2+l)*NUM_COLUMNS+c]=INVALID_MEASUREMENT;
+        else results[1+(j+2+l)*NUM_COLUMNS+c]=(wakeup_percentiles[l*NUM_RESULTS+k]/mdp->cpuinfo->clockrate)*1000000000;
+      }
+    }
+    if (PAGE_FAULT_MODE){
+      if (mdp->fault_results[k]==INVALID_MEASUREMENT) results[1+(j+2)*NUM_COLUMNS+c]=INVALID_MEASUREMENT;
+      else results[1+(j+2)*NUM_COLUMNS+c]=(mdp->fault_results[k]/mdp->cpuinfo->clockrate)*1000;
+    }
+  }
+  sc++;
+  }while(sc<NUM_SCENARIOS);
+
+  /* keep the smallest result of repeated measurements for the plateau analysis */
+  if (PLATEAU_ANALYSIS){
+    plateau_sizes[problemsize-1]=(double)rps;
+    for (k=0;k<NUM_RESULTS;k++){
+      if ((tmp_results[k]>0)&&((plateau_cycles[(problemsize-1)*NUM_RESULTS+k]<=0)||(tmp_results[k]<plateau_cycles[(problemsize-1)*NUM_RESULTS+k])))
+        plateau_cycles[(problemsize-1)*NUM_RESULTS+k]=tmp_results[k];
+    }
   }
   return 0;
 }
@@ -628,8 +1643,27 @@ void bi_cleanup( void* mdpv )
    } 
    pthread_kill(watchdog,SIGUSR1);
 
+   if (SMT_LOAD){
+     double rate=stop_smt_load();
+     if (SMT_LOAD==SMT_LOAD_ALU) printf("  SMT load: %.2f G instructions/s\n",rate/1000000000);
+     else printf("  SMT load: %.2f GB/s\n",rate/1000000000);
+   }
+
+   if (PLATEAU_ANALYSIS){
+     plateau_analysis(mdp);
+     free(plateau_sizes);
+     free(plateau_cycles);
+   }
+
+   /* terminate helper processes */
+   if (mdp->helpers){
+     stop_helper_processes(mdp);
+     free(mdp->helpers);
+   }
+
    /* free resources */
-   if ((HUGEPAGES==HUGEPAGES_OFF)&&(mdp->buffer)) _mm_free(mdp->buffer);
+   if ((HUGEPAGES==HUGEPAGES_OFF)&&(PROCESS_MODE)&&(mdp->buffer)) munmap((void*)mdp->buffer,BUFFERSIZE);
+   else if ((HUGEPAGES==HUGEPAGES_OFF)&&(mdp->buffer)) _mm_free(mdp->buffer);
    if (HUGEPAGES==HUGEPAGES_ON){
      if(mdp->buffer!=NULL) munmap((void*)mdp->buffer,BUFFERSIZE);
    }
@@ -642,11 +1676,22 @@ void bi_cleanup( void* mdpv )
      _mm_free(mdp->threaddata);   
    }
    if (mdp->threads) _mm_free(mdp->threads);
-   if (mdp->thread_comm) _mm_free(mdp->thread_comm);
+   if (mdp->thread_comm) _mm_free((void*)mdp->thread_comm);
    if (mdp->cpuinfo) _mm_free(mdp->cpuinfo);
    if (mdp->tlb_tags!=NULL) _mm_free (mdp->tlb_tags);
    if (mdp->tlb_collision_check_array!=NULL) _mm_free (mdp->tlb_collision_check_array);
    if (mdp->page_address) free(mdp->page_address); 
+   if (mdp->noise_results) free(mdp->noise_results);
+   if (mdp->fault_results) free(mdp->fault_results);
+   if (sweep_results) free(sweep_results);
+   if (sweep_index) free(sweep_index);
+   if (wakeup_percentiles) free(wakeup_percentiles);
+   if (mdp->sampling){
+     close(mdp->sampling->fd);
+     if (mdp->sampling->segments) free(mdp->sampling->segments);
+     if (mdp->sampling->samples) _mm_free(mdp->sampling->samples);
+     free(mdp->sampling);
+   }
    _mm_free( mdp );
    return;
 }
@@ -737,6 +1782,31 @@ void evaluate_environment(bi_info * info)
      _random_init(time.tv_usec,problemlistsize);
      for (i=0;i<problemlistsize;i++) problemarray2[i] = problemarray1[(int) _random()];
    }
+
+   /* time-series sampling: a single data set size replaces the list of data set sizes */
+   p = bi_getenv( "BENCHIT_KERNEL_SAMPLE_DURATION", 0 );
+   if (p) SAMPLE_DURATION=atoi(p);
+   if (SAMPLE_DURATION<0) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_SAMPLE_DURATION");}
+   if (SAMPLE_DURATION){
+     p = bi_getenv( "BENCHIT_KERNEL_SAMPLE_SIZE", 0 );
+     if ( p == 0 ) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SAMPLE_SIZE not set");}
+     else SAMPLE_SIZE=atoll(p);
+     p = bi_getenv( "BENCHIT_KERNEL_SAMPLE_PASSES", 0 );
+     if (p) SAMPLE_PASSES=atoi(p);
+     if (SAMPLE_PASSES<1) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_SAMPLE_PASSES");}
+     p = bi_getenv( "BENCHIT_KERNEL_SAMPLE_MAX", 0 );
+     if (p) SAMPLE_MAX=atoll(p);
+     if (SAMPLE_MAX<1) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_SAMPLE_MAX");}
+     p = bi_getenv( "BENCHIT_KERNEL_SAMPLE_FILE", 0 );
+     if ((p)&&(strcmp(p,""))) SAMPLE_FILE=bi_strdup(p);
+     else {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SAMPLE_FILE not set");}
+     if (SAMPLE_SIZE){
+       problemlistsize=1;
+       problemarray1[0]=(double)SAMPLE_SIZE;
+       if (RANDOM) problemarray2[0]=(double)SAMPLE_SIZE;
+       MAX=SAMPLE_SIZE;
+     }
+   }
  
    CPU_ZERO(&cpuset);NUM_THREADS==0;
    if (bi_getenv( "BENCHIT_KERNEL_CPU_LIST", 0 )!=NULL) p=bi_strdup(bi_getenv( "BENCHIT_KERNEL_CPU_LIST", 0 ));else p=NULL;
@@ -845,11 +1915,8 @@ void evaluate_environment(bi_info * info)
    p = bi_getenv( "BENCHIT_KERNEL_FLUSH_MODE", 0 );
    if ( p == 0 ) FLUSH_MODE=MODE_EXCLUSIVE;
    else{ 
-     if (!strcmp(p,"M")) FLUSH_MODE=MODE_MODIFIED;
-     else if (!strcmp(p,"E")) FLUSH_MODE=MODE_EXCLUSIVE;
-     else if (!strcmp(p,"I")) FLUSH_MODE=MODE_INVALID;
-     else if (!strcmp(p,"R")) FLUSH_MODE=MODE_RDONLY;
-     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_FLUSH_MODE");};
+     FLUSH_MODE=parse_flush_mode(p);
+     if (FLUSH_MODE<0) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_FLUSH_MODE");};
    }
 
    p = bi_getenv( "BENCHIT_KERNEL_FLUSH_BUFFER", 0 );
@@ -863,6 +1930,9 @@ void evaluate_environment(bi_info * info)
    p = bi_getenv( "BENCHIT_KERNEL_ALWAYS_FLUSH_CPU0", 0 );
    if ( p != 0 ) ALWAYS_FLUSH_CPU0 = atoi( p );
 
+   p = bi_getenv( "BENCHIT_KERNEL_FLUSH_TARGETED", 0 );
+   if ( p != 0 ) FLUSH_TARGETED = atoi( p );
+
    p = bi_getenv( "BENCHIT_KERNEL_FLUSH_EXTRA", 0 );
    if ( p != 0 ) EXTRA_FLUSH_SIZE = atoi( p );
    if ((EXTRA_FLUSH_SIZE < 0) || (EXTRA_FLUSH_SIZE > 1000)){
@@ -886,16 +1956,40 @@ void evaluate_environment(bi_info * info)
    p = bi_getenv( "BENCHIT_KERNEL_USE_MODE", 0 );
    if ( p == 0 ) USE_MODE=MODE_EXCLUSIVE;
    else { 
-     if (!strcmp(p,"M")) USE_MODE=MODE_MODIFIED;
-     else if (!strcmp(p,"E")) USE_MODE=MODE_EXCLUSIVE;
-     else if (!strcmp(p,"I")) USE_MODE=MODE_INVALID;
-     else if (!strcmp(p,"S")) USE_MODE=MODE_SHARED;
-     else if (!strcmp(p,"O")) USE_MODE=MODE_OWNED;
-     else if (!strcmp(p,"F")) USE_MODE=MODE_FORWARD;
-     else if (!strcmp(p,"U")) USE_MODE=MODE_MUW;
-     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_USE_MODE");}
-   }
-   if ((USE_MODE==MODE_SHARED)||(USE_MODE==MODE_OWNED)||(USE_MODE==MODE_FORWARD)||(USE_MODE==MODE_MUW))
+     USE_MODE_NAME=bi_strdup(p);
+     USE_MODE=parse_use_mode(p);
+     if (USE_MODE<0) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_USE_MODE");}
+   }
+
+   /* scenarios measured in one run, the settings above are the defaults */
+   p=bi_getenv( "BENCHIT_KERNEL_SCENARIO_FILE", 0 );
+   if ((p!=0)&&(strcmp(p,""))){
+     SCENARIO_FILE=bi_strdup(p);
+     errors+=read_scenarios(SCENARIO_FILE);
+   }
+   /* result columns: the selected CPUs of each scenario, all CPUs without scenarios */
+   if (NUM_SCENARIOS){
+     for (i=0;i<NUM_SCENARIOS;i++) NUM_COLUMNS+=scenarios[i].num_threads;
+     column_thread=(int*)malloc(NUM_COLUMNS*sizeof(int));
+     column_scenario=(int*)malloc(NUM_COLUMNS*sizeof(int));
+     NUM_COLUMNS=0;
+     for (i=0;i<NUM_SCENARIOS;i++){
+       int t;
+       for (t=0;t<scenarios[i].num_threads;t++){
+         column_thread[NUM_COLUMNS]=scenarios[i].threads[t];
+         column_scenario[NUM_COLUMNS]=i;
+         NUM_COLUMNS++;
+       }
+     }
+   }
+   else{
+     NUM_COLUMNS=NUM_RESULTS;
+     column_thread=(int*)malloc(NUM_COLUMNS*sizeof(int));
+     column_scenario=(int*)calloc(NUM_COLUMNS,sizeof(int));
+     for (i=0;i<NUM_COLUMNS;i++) column_thread[i]=i;
+   }
+
+   if ((USE_MODE==MODE_SHARED)||(USE_MODE==MODE_OWNED)||(USE_MODE==MODE_FORWARD)||(USE_MODE==MODE_MUW)||(SCENARIO_SHARED))
    {
     if (bi_getenv( "BENCHIT_KERNEL_SHARED_CPU_LIST", 0 )!=NULL) p=bi_strdup(bi_getenv( "BENCHIT_KERNEL_SHARED_CPU_LIST", 0 ));else p=NULL;
      if (p==0) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SHARE_CPU not set, required by selected BENCHIT_KERNEL_USE_MODE");}
@@ -937,6 +2031,72 @@ void evaluate_environment(bi_info * info)
      while(p!=NULL);
     }
    }
+
+   /* sweep CPUs are appended to the threads, they measure the local latency of sizes up to L2 concurrently */
+   if (bi_getenv( "BENCHIT_KERNEL_SWEEP_CPU_LIST", 0 )!=NULL) p=bi_strdup(bi_getenv( "BENCHIT_KERNEL_SWEEP_CPU_LIST", 0 ));else p=NULL;
+   if ((p!=NULL)&&(strlen(p)>0)){
+     char *q,*r,*s;
+     int j,k,first=NUM_THREADS,shared;
+
+     do{
+       q=strstr(p,",");if (q) {*q='\0';q++;}
+       s=strstr(p,"/");if (s) {*s='\0';s++;}
+       r=strstr(p,"-");if (r) {*r='\0';r++;}
+
+       if ((s)&&(r)) for (i=atoi(p);i<=atoi(r);i+=atoi(s)) {if (cpu_allowed(i)) {CPU_SET(i,&cpuset);NUM_THREADS++;}}
+       else if (r) for (i=atoi(p);i<=atoi(r);i++) {if (cpu_allowed(i)) {CPU_SET(i,&cpuset);NUM_THREADS++;}}
+       else if (cpu_allowed(atoi(p))) {CPU_SET(atoi(p),&cpuset);NUM_THREADS++;}
+       p=q;
+     }while(p!=NULL);
+
+     j=first;
+     NUM_SWEEP_CPUS=NUM_THREADS-first;
+     cpu_bind=(unsigned long long*)realloc((void*)cpu_bind,(NUM_THREADS)*sizeof(unsigned long long));
+
+     p=bi_strdup(bi_getenv( "BENCHIT_KERNEL_SWEEP_CPU_LIST", 0 ));
+     do
+     {
+       q=strstr(p,",");if (q) {*q='\0';q++;}
+       s=strstr(p,"/");if (s) {*s='\0';s++;}
+       r=strstr(p,"-");if (r) {*r='\0';r++;}
+
+       if ((s)&&(r)) for (i=atoi(p);i<=atoi(r);i+=atoi(s)) {if (cpu_allowed(i)) {cpu_bind[j]=i;j++;}}
+       else if (r) for (i=atoi(p);i<=atoi(r);i++) {if (cpu_allowed(i)) {cpu_bind[j]=i;j++;}}
+       else if (cpu_allowed(atoi(p))) {cpu_bind[j]=atoi(p);j++;}
+       p=q;
+     }
+     while(p!=NULL);
+
+     if (NUM_SWEEP_CPUS==0) {errors++;sprintf(error_msg,"No allowed CPUs in BENCHIT_KERNEL_SWEEP_CPU_LIST");}
+     /* a sweep CPU must not share its L2 with any other thread, neither with the measuring CPUs nor with other sweep CPUs
+      * and has the core type of the first CPU, its curves are the local latencies of that CPU */
+     for (j=first;j<NUM_THREADS;j++){
+       if (strcmp(core_type(cpu_bind[j]),core_type(cpu_bind[0]))) {errors++;sprintf(error_msg,"CPU %llu in BENCHIT_KERNEL_SWEEP_CPU_LIST has another core type than CPU %llu",cpu_bind[j],cpu_bind[0]);}
+       for (k=0;k<j;k++){
+         shared=shares_l2(cpu_bind[j],cpu_bind[k]);
+         if (shared==1) {errors++;sprintf(error_msg,"CPU %llu in BENCHIT_KERNEL_SWEEP_CPU_LIST shares its L2 cache with CPU %llu",cpu_bind[j],cpu_bind[k]);}
+         if (shared==-1) {fprintf( stderr, "Warning: L2 topology of CPU %llu unknown, make sure CPUs in BENCHIT_KERNEL_SWEEP_CPU_LIST share no L2 cache with other CPUs\n",cpu_bind[j]); fflush(stderr);break;}
+       }
+     }
+   }
+
+   p=bi_getenv( "BENCHIT_KERNEL_SHARER_SCALING", 0 );
+   if (p!=0) SHARER_SCALING=atoi(p);
+   if (SHARER_SCALING){
+     if ((USE_MODE!=MODE_SHARED)&&(USE_MODE!=MODE_FORWARD)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SHARER_SCALING requires BENCHIT_KERNEL_USE_MODE S or F");}
+     if (NUM_RESULTS<2) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SHARER_SCALING requires at least 2 CPUs in BENCHIT_KERNEL_CPU_LIST");}
+   }
+   p=bi_getenv( "BENCHIT_KERNEL_CONCURRENT_READERS", 0 );
+   if (p!=0) CONCURRENT_READERS=atoi(p);
+   if (CONCURRENT_READERS){
+     if (!SHARER_SCALING) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_CONCURRENT_READERS requires BENCHIT_KERNEL_SHARER_SCALING");}
+     /* in S mode the first CPU in SHARED_CPU_LIST holds the forward copy, the readers are taken from the end of the list */
+     else if ((CONCURRENT_READERS<0)||(CONCURRENT_READERS>NUM_SHARED_CPUS-(USE_MODE==MODE_SHARED))) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_CONCURRENT_READERS exceeds number of available CPUs in BENCHIT_KERNEL_SHARED_CPU_LIST");}
+   }
+
+   p=bi_getenv( "BENCHIT_KERNEL_LAZY_INIT", 0 );
+   if (p!=0) LAZY_INIT=atoi(p);
+
    p=bi_getenv( "BENCHIT_KERNEL_ALLOC", 0 );
    if (p==0) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_ALLOC not set");}
    else {
@@ -962,13 +2122,15 @@ void evaluate_environment(bi_info * info)
            else if (cpu_allowed(atoi(p))) {if (j<=NUM_THREADS) mem_bind[j]=atoi(p);j++;} else {errors++;sprintf(error_msg,"selected CPU not allowed");}
            p=q;
          }
-         while((p!=NULL)&&(j<NUM_THREADS));
-         if (j<NUM_THREADS) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_MEM_BIND too short");}
+         while((p!=NULL)&&(j<NUM_THREADS-NUM_SWEEP_CPUS));
+         if (j<NUM_THREADS-NUM_SWEEP_CPUS) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_MEM_BIND too short");}
        }
        else {errors++;sprintf(error_msg,"BENCHIT_KERNEL_MEM_BIND not set, required by BENCHIT_KERNEL_ALLOC=\"B\"");}
      }
      else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_ALLOC");}
    }
+   /* sweep CPUs always use local memory */
+   if (mem_bind!=NULL) for (i=NUM_THREADS-NUM_SWEEP_CPUS;i<NUM_THREADS;i++) mem_bind[i]=cpu_bind[i];
 
    p=bi_getenv( "BENCHIT_KERNEL_HUGEPAGES", 0 );
    if (p==0) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_HUGEPAGES not set");}
@@ -1008,6 +2170,229 @@ void evaluate_environment(bi_info * info)
      else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_LOOP_OVERHEAD_COMPENSATION");}
    }
 
+   p=bi_getenv( "BENCHIT_KERNEL_NOISE_REJECTION", 0 );
+   if (p!=0){
+     if (!strcmp(p,"0")) NOISE_REJECTION=NOISE_REJECTION_OFF;
+     else if (!strcmp(p,"1")) NOISE_REJECTION=NOISE_REJECTION_ON;
+     else if (!strcmp(p,"2")) NOISE_REJECTION=NOISE_REJECTION_STRICT;
+     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_NOISE_REJECTION");}
+   }
+   p=bi_getenv( "BENCHIT_KERNEL_NOISE_MAX_RETRIES", 0 );
+   if (p!=0) NOISE_RETRIES=atoi(p);
+   if ((NOISE_RETRIES<0)||(NOISE_RETRIES>65535)) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_NOISE_MAX_RETRIES");}
+   /* the disturbances are part of the time series, rejecting them would also duplicate samples in the file */
+   if ((NOISE_REJECTION)&&(SAMPLE_DURATION)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_NOISE_REJECTION can not be combined with BENCHIT_KERNEL_SAMPLE_DURATION");}
+
+   p=bi_getenv( "BENCHIT_KERNEL_PROCESS_MODE", 0 );
+   if (p!=0) PROCESS_MODE=atoi(p);
+   /* the helper processes would update private copies of the TLB check arrays and chain segment addresses */
+   if ((PROCESS_MODE)&&((NOISE_REJECTION)||(TLB_MODE)||(SAMPLE_DURATION))) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_PROCESS_MODE can not be combined with noise rejection, TLB mode or sampling");}
+
+   p=bi_getenv( "BENCHIT_KERNEL_PAGE_FAULT_MODE", 0 );
+   if ((p!=0)&&(strcmp(p,"disabled"))){
+     if (!strcmp(p,"4K")) PAGE_FAULT_MODE=PAGE_FAULT_4K;
+     else if (!strcmp(p,"THP")) PAGE_FAULT_MODE=PAGE_FAULT_THP;
+     else if (!strcmp(p,"HUGETLB")) PAGE_FAULT_MODE=PAGE_FAULT_HUGETLB;
+     else if (!strcmp(p,"POPULATE")) PAGE_FAULT_MODE=PAGE_FAULT_POPULATE;
+     else if (!strcmp(p,"WILLNEED")) PAGE_FAULT_MODE=PAGE_FAULT_WILLNEED;
+     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_PAGE_FAULT_MODE");}
+     PAGE_FAULT_NAME=bi_strdup(p);
+     if ((NOISE_REJECTION)||(SHARER_SCALING)||(SAMPLE_DURATION)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_PAGE_FAULT_MODE can not be combined with noise rejection, sharer scaling or sampling");}
+   }
+
+   p=bi_getenv( "BENCHIT_KERNEL_CODE_LATENCY", 0 );
+   if ((p!=0)&&(strcmp(p,"disabled"))){
+     if (!strcmp(p,"4K")) CODE_LATENCY=CODE_LATENCY_4K;
+     else if (!strcmp(p,"THP")) CODE_LATENCY=CODE_LATENCY_THP;
+     else if (!strcmp(p,"HUGETLB")) CODE_LATENCY=CODE_LATENCY_HUGETLB;
+     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_CODE_LATENCY");}
+     CODE_LATENCY_NAME=bi_strdup(p);
+     if ((NOISE_REJECTION)||(SHARER_SCALING)||(SAMPLE_DURATION)||(PAGE_FAULT_MODE)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_CODE_LATENCY can not be combined with noise rejection, sharer scaling, sampling or first-touch latency");}
+     /* jmp instructions with 32 bit displacement */
+     if (MAX>=0x80000000ULL) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_CODE_LATENCY supports data set sizes up to 2 GiB");}
+   }
+
+   if (NUM_SWEEP_CPUS){
+     if ((USE_MODE!=MODE_EXCLUSIVE)&&(USE_MODE!=MODE_MODIFIED)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SWEEP_CPU_LIST requires BENCHIT_KERNEL_USE_MODE E or M");}
+     if ((NOISE_REJECTION)||(SHARER_SCALING)||(SAMPLE_DURATION)||(PAGE_FAULT_MODE)||(CODE_LATENCY)||(PROCESS_MODE)||(TLB_MODE)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SWEEP_CPU_LIST can not be combined with noise rejection, sharer scaling, sampling, first-touch latency, instruction fetch latency, process mode or TLB mode");}
+   }
+
+   p=bi_getenv( "BENCHIT_KERNEL_DRAM_MODE", 0 );
+   if ((p)&&(strcmp(p,""))){
+     if (!strcmp(p,"ROW_HIT")) DRAM_MODE=DRAM_MODE_ROW_HIT;
+     else if (!strcmp(p,"ROW_CONFLICT")) DRAM_MODE=DRAM_MODE_ROW_CONFLICT;
+     else if (!strcmp(p,"BANK_SPREAD")) DRAM_MODE=DRAM_MODE_BANK_SPREAD;
+     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_DRAM_MODE");}
+     DRAM_MODE_NAME=bi_strdup(p);
+   }
+   p=bi_getenv( "BENCHIT_KERNEL_DRAM_BANK_FUNCTIONS", 0 );
+   if ((p)&&(strcmp(p,""))){
+     char *q;
+     p=bi_strdup(p);
+     do{
+       q=strstr(p,",");if (q) {*q='\0';q++;}
+       if (DRAM_NUM_FUNCTIONS>=DRAM_MAX_FUNCTIONS) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_DRAM_BANK_FUNCTIONS supports up to %i functions",DRAM_MAX_FUNCTIONS);break;}
+       DRAM_FUNCTIONS[DRAM_NUM_FUNCTIONS]=strtoull(p,NULL,0);
+       if (DRAM_FUNCTIONS[DRAM_NUM_FUNCTIONS]==0) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_DRAM_BANK_FUNCTIONS");}
+       DRAM_NUM_FUNCTIONS++;
+       p=q;
+     }while(p!=NULL);
+   }
+   p=bi_getenv( "BENCHIT_KERNEL_DRAM_ROW_SHIFT", 0 );
+   if (p!=0) DRAM_ROW_SHIFT=atoi(p);
+   if ((DRAM_ROW_SHIFT<6)||(DRAM_ROW_SHIFT>40)) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_DRAM_ROW_SHIFT");}
+   p=bi_getenv( "BENCHIT_KERNEL_DRAM_SOLVE", 0 );
+   if (p!=0) DRAM_SOLVE=atoi(p);
+   if (DRAM_SOLVE){
+     p=bi_getenv( "BENCHIT_KERNEL_DRAM_SOLVE_SIZE", 0 );
+     if (p!=0) DRAM_SOLVE_SIZE=strtoull(p,NULL,0);
+     p=bi_getenv( "BENCHIT_KERNEL_DRAM_SOLVE_SAMPLES", 0 );
+     if (p!=0) DRAM_SOLVE_SAMPLES=atoi(p);
+     p=bi_getenv( "BENCHIT_KERNEL_DRAM_THRESHOLD", 0 );
+     if (p!=0) DRAM_THRESHOLD=strtoull(p,NULL,0);
+     if ((DRAM_SOLVE_SIZE<4096)||(DRAM_SOLVE_SAMPLES<16)||((unsigned long long)DRAM_SOLVE_SAMPLES>DRAM_SOLVE_SIZE/64)) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_DRAM_SOLVE_SIZE or BENCHIT_KERNEL_DRAM_SOLVE_SAMPLES");}
+   }
+   if (DRAM_MODE){
+     if ((!DRAM_NUM_FUNCTIONS)&&(!DRAM_SOLVE)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_DRAM_MODE requires BENCHIT_KERNEL_DRAM_BANK_FUNCTIONS or BENCHIT_KERNEL_DRAM_SOLVE");}
+     if ((TLB_MODE)||(CODE_LATENCY)||(PAGE_FAULT_MODE)||(NUM_SWEEP_CPUS)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_DRAM_MODE can not be combined with TLB mode, instruction fetch latency, first-touch latency, or sweep CPUs");}
+     /* rows span several 4 KiB pages, chains within a row or bank require physically contiguous huge pages */
+     if (HUGEPAGES==HUGEPAGES_OFF) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_DRAM_MODE requires BENCHIT_KERNEL_HUGEPAGES=1");}
+   }
+
+   p=bi_getenv( "BENCHIT_KERNEL_STRUCTURE", 0 );
+   if ((p)&&(strcmp(p,""))&&(strcmp(p,"disabled"))){
+     if (!strcmp(p,"BTREE_64")) STRUCTURE=STRUCTURE_BTREE_64;
+     else if (!strcmp(p,"BTREE_128")) STRUCTURE=STRUCTURE_BTREE_128;
+     else if (!strcmp(p,"BTREE_256")) STRUCTURE=STRUCTURE_BTREE_256;
+     else if (!strcmp(p,"BTREE_512")) STRUCTURE=STRUCTURE_BTREE_512;
+     else if (!strcmp(p,"HASH_OPEN")) STRUCTURE=STRUCTURE_HASH_OPEN;
+     else if (!strcmp(p,"HASH_CHAINED")) STRUCTURE=STRUCTURE_HASH_CHAINED;
+     else if (!strcmp(p,"TREE_AOS")) STRUCTURE=STRUCTURE_TREE_AOS;
+     else if (!strcmp(p,"TREE_SOA")) STRUCTURE=STRUCTURE_TREE_SOA;
+     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_STRUCTURE");}
+     STRUCTURE_NAME=bi_strdup(p);
+     if ((DRAM_MODE)||(TLB_MODE)||(CODE_LATENCY)||(PAGE_FAULT_MODE)||(NUM_SWEEP_CPUS)||(SAMPLE_DURATION)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_STRUCTURE can not be combined with DRAM mode, TLB mode, instruction fetch latency, first-touch latency, sweep CPUs, or sampling");}
+   }
+
+   p=bi_getenv( "BENCHIT_KERNEL_WAKEUP_MODE", 0 );
+   if ((p)&&(strcmp(p,""))&&(strcmp(p,"disabled"))){
+     if (!strcmp(p,"FUTEX")) WAKEUP_MODE=WAKEUP_FUTEX;
+     else if (!strcmp(p,"EVENTFD")) WAKEUP_MODE=WAKEUP_EVENTFD;
+     else if (!strcmp(p,"PIPE")) WAKEUP_MODE=WAKEUP_PIPE;
+     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_WAKEUP_MODE");}
+     WAKEUP_NAME=bi_strdup(p);
+     p=bi_getenv( "BENCHIT_KERNEL_WAKEUP_SAMPLES", 0 );
+     if (p!=0) WAKEUP_SAMPLES=atoi(p);
+     if (WAKEUP_SAMPLES<1) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_WAKEUP_SAMPLES");}
+     if (NUM_THREADS<2) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_WAKEUP_MODE requires at least 2 CPUs in BENCHIT_KERNEL_CPU_LIST");}
+     if ((NOISE_REJECTION)||(SHARER_SCALING)||(SAMPLE_DURATION)||(PAGE_FAULT_MODE)||(CODE_LATENCY)||(NUM_SWEEP_CPUS)||(DRAM_MODE)||(STRUCTURE)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_WAKEUP_MODE can not be combined with noise rejection, sharer scaling, sampling, first-touch latency, instruction fetch latency, sweep CPUs, DRAM mode or data structure chains");}
+   }
+
+   p=bi_getenv( "BENCHIT_KERNEL_FENCE_COST", 0 );
+   if (p!=0) FENCE_COST=atoi(p);
+   if (FENCE_COST){
+     p=bi_getenv( "BENCHIT_KERNEL_FENCE_ITERATIONS", 0 );
+     if (p!=0) FENCE_ITERATIONS=strtoull(p,NULL,0);
+     if (FENCE_ITERATIONS<10) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_FENCE_ITERATIONS");}
+   }
+   p=bi_getenv( "BENCHIT_KERNEL_PREFETCH_ADVISOR", 0 );
+   if ((p!=0)&&(strcmp(p,"disabled"))&&(strcmp(p,""))){
+     if (!strcmp(p,"index")) PREFETCH_ADVISOR=PREFETCH_INDEX;
+     else if (!strcmp(p,"chain")) PREFETCH_ADVISOR=PREFETCH_CHAIN;
+     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_PREFETCH_ADVISOR");}
+     PREFETCH_ADVISOR_NAME=bi_strdup(p);
+     p=bi_getenv( "BENCHIT_KERNEL_PREFETCH_ACCESSES", 0 );
+     if (p!=0) PREFETCH_ACCESSES=strtoull(p,NULL,0);
+     if (PREFETCH_ACCESSES<1000) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_PREFETCH_ACCESSES");}
+     i=parse_int_list("BENCHIT_KERNEL_PREFETCH_DISTANCES",PREFETCH_DISTANCES,32,1,4096);
+     if (i<0) errors++;
+     else if (i>0) PREFETCH_NUM_DISTANCES=i;
+   }
+   p=bi_getenv( "BENCHIT_KERNEL_STORE_FORWARDING", 0 );
+   if (p!=0) STORE_FORWARDING=atoi(p);
+   if (STORE_FORWARDING){
+     p=bi_getenv( "BENCHIT_KERNEL_FORWARDING_ITERATIONS", 0 );
+     if (p!=0) FORWARD_ITERATIONS=strtoull(p,NULL,0);
+     if (FORWARD_ITERATIONS<10) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_FORWARDING_ITERATIONS");}
+     i=parse_int_list("BENCHIT_KERNEL_ALIASING_DISTANCES",ALIASING_DISTANCES,32,0,16*1024*1024);
+     if (i<0) errors++;
+     else if (i>0) ALIASING_NUM_DISTANCES=i;
+   }
+   p=bi_getenv( "BENCHIT_KERNEL_INTERLEAVED_LOOKUPS", 0 );
+   if (p!=0) INTERLEAVED_LOOKUPS=atoi(p);
+   if (INTERLEAVED_LOOKUPS){
+     p=bi_getenv( "BENCHIT_KERNEL_INTERLEAVED_ACCESSES", 0 );
+     if (p!=0) INTERLEAVED_ACCESSES=strtoull(p,NULL,0);
+     if (INTERLEAVED_ACCESSES<1000) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_INTERLEAVED_ACCESSES");}
+     i=parse_int_list("BENCHIT_KERNEL_INTERLEAVED_GROUPS",INTERLEAVED_GROUPS,INTERLEAVED_MAX_GROUPS,1,INTERLEAVED_MAX_GROUPS);
+     if (i<0) errors++;
+     else if (i>0) INTERLEAVED_NUM_GROUPS=i;
+   }
+   p=bi_getenv( "BENCHIT_KERNEL_VICTIM_PATH", 0 );
+   if (p!=0) VICTIM_PATH=atoi(p);
+   if (VICTIM_PATH){
+     p=bi_getenv( "BENCHIT_KERNEL_VICTIM_LINES", 0 );
+     if (p!=0) VICTIM_LINES=strtoull(p,NULL,0);
+     if ((VICTIM_LINES)&&(VICTIM_LINES<16)) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_VICTIM_LINES");}
+     p=bi_getenv( "BENCHIT_KERNEL_VICTIM_THRESHOLD", 0 );
+     if (p!=0) VICTIM_THRESHOLD=strtoull(p,NULL,0);
+   }
+   #if defined(COMPUTE_FENCE) && (COMPUTE_FENCE==FENCE_SERIALIZE)
+   if (!fence_supported(FENCE_SERIALIZE)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_COMPUTE_MODE=serialize is not supported by this CPU");}
+   #endif
+
+   p=bi_getenv( "BENCHIT_KERNEL_PLATEAU_ANALYSIS", 0 );
+   if (p!=0) PLATEAU_ANALYSIS=atoi(p);
+   if (PLATEAU_ANALYSIS){
+     p=bi_getenv( "BENCHIT_KERNEL_PLATEAU_MIN_POINTS", 0 );
+     if (p!=0) PLATEAU_MIN_POINTS=atoi(p);
+     if (PLATEAU_MIN_POINTS<1) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_PLATEAU_MIN_POINTS");}
+     p=bi_getenv( "BENCHIT_KERNEL_PLATEAU_FILE", 0 );
+     if ((p)&&(strcmp(p,""))) PLATEAU_FILE=bi_strdup(p);
+     else {errors++;sprintf(error_msg,"BENCHIT_KERNEL_PLATEAU_FILE not set");}
+   }
+
+   if ((NUM_SCENARIOS)&&((SHARER_SCALING)||(SAMPLE_DURATION)||(PAGE_FAULT_MODE)||(CODE_LATENCY)||(WAKEUP_MODE)||(NUM_SWEEP_CPUS)||(PLATEAU_ANALYSIS))) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SCENARIO_FILE can not be combined with sharer scaling, sampling, first-touch latency, instruction fetch latency, wake-up latency, sweep CPUs or plateau analysis");}
+
+   p=bi_getenv( "BENCHIT_KERNEL_VERIFY_PLACEMENT", 0 );
+   if (p!=0) VERIFY_PLACEMENT_MODE=atoi(p);
+   if ((VERIFY_PLACEMENT_MODE<0)||(VERIFY_PLACEMENT_MODE>2)) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_VERIFY_PLACEMENT");}
+
+   p=bi_getenv( "BENCHIT_KERNEL_SEED", 0 );
+   if (p!=0) CHAIN_SEED=strtoull(p,NULL,0);
+   p=bi_getenv( "BENCHIT_KERNEL_CHAIN_CACHE_DIR", 0 );
+   if ((p)&&(strcmp(p,""))){
+     CHAIN_CACHE_DIR=bi_strdup(p);
+     if (!CHAIN_SEED) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_CHAIN_CACHE_DIR requires BENCHIT_KERNEL_SEED");}
+     if ((mkdir(CHAIN_CACHE_DIR,0755)!=0)&&(access(CHAIN_CACHE_DIR,W_OK|X_OK)!=0)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_CHAIN_CACHE_DIR is not a writable directory");}
+     if ((TLB_MODE)&&(HUGEPAGES==HUGEPAGES_OFF)) printf("  Warning: pointer chains are not cached in TLB mode without huge pages\n");
+   }
+
+   p=bi_getenv( "BENCHIT_KERNEL_SMT_LOAD", 0 );
+   if ((p)&&(strcmp(p,""))){
+     if (!strcmp(p,"ALU")) SMT_LOAD=SMT_LOAD_ALU;
+     else if (!strcmp(p,"L1")) SMT_LOAD=SMT_LOAD_L1;
+     else if (!strcmp(p,"L2")) SMT_LOAD=SMT_LOAD_L2;
+     else if (!strcmp(p,"DRAM")) SMT_LOAD=SMT_LOAD_DRAM;
+     else {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_SMT_LOAD");}
+     SMT_LOAD_NAME=bi_strdup(p);
+   }
+   if (SMT_LOAD){
+     SMT_CPU=smt_sibling(cpu_bind[0]);
+     if (SMT_CPU==-1) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SMT_LOAD: CPU %llu has no SMT sibling",cpu_bind[0]);}
+     for (i=0;i<NUM_THREADS;i++) if ((SMT_CPU!=-1)&&(cpu_bind[i]==(unsigned long long)SMT_CPU)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SMT_LOAD: SMT sibling CPU %i is used by thread %i",SMT_CPU,i);}
+   }
+
+   p=bi_getenv( "BENCHIT_KERNEL_SCHED_FIFO", 0 );
+   if (p!=0) SCHED_PRIO=atoi(p);
+   if ((SCHED_PRIO<0)||(SCHED_PRIO>99)) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_SCHED_FIFO");}
+
+   p=bi_getenv( "BENCHIT_KERNEL_MLOCKALL", 0 );
+   if (p!=0) MLOCK_MEMORY=atoi(p);
+   if ((MLOCK_MEMORY<0)||(MLOCK_MEMORY>1)) {errors++;sprintf(error_msg,"invalid setting for BENCHIT_KERNEL_MLOCKALL");}
+   /* locking faults in the whole buffers at once */
+   if ((MLOCK_MEMORY)&&(LAZY_INIT)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_MLOCKALL can not be combined with BENCHIT_KERNEL_LAZY_INIT");}
+
    p=bi_getenv( "BENCHIT_KERNEL_TIMEOUT", 0 );
    if (p!=0){
      TIMEOUT=atoi(p);
@@ -1114,7 +2499,10 @@ void evaluate_environment(bi_info * info)
           }
         }
       }
-      if (papi_num_counters>0) PAPI_start(EventSet);
+      /* the counters are attached to the measuring CPU, they do not see the local measurements on the sweep CPUs */
+      if ((papi_num_counters>0)&&(NUM_SWEEP_CPUS)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_SWEEP_CPU_LIST can not be combined with PAPI counters");}
+      else if ((papi_num_counters>0)&&(WAKEUP_MODE)) {errors++;sprintf(error_msg,"BENCHIT_KERNEL_WAKEUP_MODE can not be combined with PAPI counters");}
+      else if (papi_num_counters>0) PAPI_start(EventSet);
    }
    #endif
 
@@ -1148,21 +2536,25 @@ void evaluate_environment(bi_info * info)
 
    
 
-   if (!strcmp("GenuineIntel",cpuinfo->vendor)){
-     if (USE_MODE==MODE_MUW){
-         fprintf( stderr, "Error: USE_MODE U not supported on Intel CPUs!\n" );
-         exit( 1 );
-       }
-     if (USE_MODE==MODE_OWNED){
-         fprintf( stderr, "Error: USE_MODE O not supported on Intel CPUs!\n" );
-         exit( 1 );
-       }
-   }
-   if (!strcmp("AuthenticAMD",cpuinfo->vendor)){
-     if (USE_MODE==MODE_FORWARD){
-         fprintf( stderr, "Error: USE_MODE F not supported on AMD CPUs!\n" );
-         exit( 1 );
-       }
+   /* USE_MODE of the PARAMETERS file and of all scenarios */
+   for (i=-1;i<NUM_SCENARIOS;i++){
+     int mode=(i<0)?USE_MODE:scenarios[i].use_mode;
+     if (!strcmp("GenuineIntel",cpuinfo->vendor)){
+       if (mode==MODE_MUW){
+           fprintf( stderr, "Error: USE_MODE U not supported on Intel CPUs!\n" );
+           exit( 1 );
+         }
+       if (mode==MODE_OWNED){
+           fprintf( stderr, "Error: USE_MODE O not supported on Intel CPUs!\n" );
+           exit( 1 );
+         }
+     }
+     if (!strcmp("AuthenticAMD",cpuinfo->vendor)){
+       if (mode==MODE_FORWARD){
+           fprintf( stderr, "Error: USE_MODE F not supported on AMD CPUs!\n" );
+           exit( 1 );
+         }
+     }
    }
 
     
@@ -17,6 +17,7 @@
  *       - memory layout improvements (as for single-r1w1)
  */
 
+#define _GNU_SOURCE
 #include "interface.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -29,12 +30,22 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
 #include <assert.h>
 #include <errno.h>
 #include <unistd.h>
 #include <limits.h>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <numaif.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/futex.h>
+#include <cpuid.h>
 
 #include "work.h"
+#include "analysis.h"
 
 #ifdef USE_PAPI
 #include <papi.h>
@@ -43,11 +54,70 @@
 /* report average latency instead of minimum */
 //#define AVERAGE
 
-/* add data dependencies in kernel versions with arithmetic operations between the loads */
-//#define DEPENDENT
-
 int iteration,accesses,alignment;
 
+/* deterministic pointer chains and chain cache (BENCHIT_KERNEL_SEED, BENCHIT_KERNEL_CHAIN_CACHE_DIR) */
+static unsigned long long chain_seed=0;
+static char *chain_cache_dir=NULL;
+
+/* load thread on the SMT sibling (BENCHIT_KERNEL_SMT_LOAD) */
+static pthread_t smt_thread;
+static volatile int smt_stop=0,smt_ready=0;
+static int smt_cpu,smt_mode;
+static unsigned long long smt_size,smt_count;
+static volatile unsigned long long smt_sum;
+static struct timeval smt_start,smt_end;
+
+/* DRAM address mapping (BENCHIT_KERNEL_DRAM_MODE) */
+static int dram_mode=DRAM_MODE_OFF,dram_num_functions=0,dram_row_shift=18,dram_warned=0;
+static unsigned long long dram_functions[DRAM_MAX_FUNCTIONS];
+
+/* linked data structure layouts (BENCHIT_KERNEL_STRUCTURE), the accesses per node or lookup are kept in the threaddata
+ * of the buffer (structure_hops) */
+static int structure_mode=STRUCTURE_OFF,structure_warned=0;
+
+/* wake-up latency (BENCHIT_KERNEL_WAKEUP_MODE), one target thread is measured at a time */
+static int wakeup_mode=WAKEUP_OFF,wakeup_samples=0,wakeup_fd[2]={-1,-1};
+static volatile int wakeup_word=0,wakeup_ready=0;
+static volatile unsigned long long wakeup_send;
+static unsigned long long *wakeup_latency=NULL;
+static double *wakeup_percentiles=NULL;
+
+/* threads measured by _work() (BENCHIT_KERNEL_SCENARIO_FILE), NULL: all threads */
+static unsigned char *measured_threads=NULL;
+
+/* targeted eviction (BENCHIT_KERNEL_FLUSH_TARGETED), conflict sets are built for L1 and L2 */
+#define EVICT_LEVELS      2
+#define EVICT_MAX_BUFFERS 64
+
+/* lines of the last generated pointer chain and the sets that contain them */
+static unsigned long long *chain_lines=NULL,chain_size=0,num_chain_lines=0,max_chain_lines=0;
+static unsigned char *chain_sets[EVICT_LEVELS];
+static int chain_sets_valid[EVICT_LEVELS];
+
+/* conflict sets in a flush buffer: ways lines per set, 0 if the buffer does not provide enough lines for a set */
+typedef struct evict_table
+{
+   char *flush_buffer;
+   unsigned long long *lines[EVICT_LEVELS];
+} evict_table_t;
+
+static evict_table_t evict_tables[EVICT_MAX_BUFFERS];
+static int num_evict_tables=0,evict_disabled=0;
+static pthread_mutex_t evict_lock=PTHREAD_MUTEX_INITIALIZER;
+
+/* header of the files in the chain cache, followed by the offsets of the chain elements relative to the buffer */
+typedef struct chain_file_header
+{
+   char magic[8];                       /* "BILATCHN" */
+   unsigned int version;
+   unsigned int alignment;
+   unsigned long long memsize;
+   unsigned long long accesses;
+   unsigned long long pagesize;
+   unsigned long long seed;
+} chain_file_header_t;
+
 /* user defined maximum value of random numbers returned by _random() */
 static unsigned long long random_max=0;
 
@@ -301,6 +371,439 @@ static int already_selected(unsigned long long addr, unsigned long long *address
    return 0;
 }
 
+void set_chain_options(unsigned long long seed, char *cache_dir)
+{
+  chain_seed=seed;
+  chain_cache_dir=cache_dir;
+}
+
+void set_dram_options(int mode, unsigned long long *functions, int num_functions, int row_shift)
+{
+  int i;
+
+  dram_mode=mode;
+  dram_num_functions=num_functions;
+  if (dram_num_functions>DRAM_MAX_FUNCTIONS) dram_num_functions=DRAM_MAX_FUNCTIONS;
+  for (i=0;i<dram_num_functions;i++) dram_functions[i]=functions[i];
+  dram_row_shift=row_shift;
+}
+
+void set_structure_options(int mode)
+{
+  structure_mode=mode;
+}
+
+void set_wakeup_options(int mode, int num_samples, double *percentiles)
+{
+  wakeup_mode=mode;
+  wakeup_samples=num_samples;
+  wakeup_percentiles=percentiles;
+}
+
+void set_measured_threads(unsigned char *measured)
+{
+  measured_threads=measured;
+}
+
+/** start value for _random_init()
+ *  - derived from BENCHIT_KERNEL_SEED, the data set size, and the run if a seed is set, from the time otherwise
+ *  - stage distinguishes the random sequences that are used for one chain
+ */
+static int random_start(unsigned long long memsize, int stage)
+{
+  struct timeval time;
+  unsigned long long x;
+
+  if (!chain_seed){
+    gettimeofday( &time, (struct timezone *) 0);
+    return time.tv_sec*time.tv_usec+pthread_self()*iteration*iteration;
+  }
+  /* splitmix64 finalizer */
+  x=chain_seed+memsize*0x9e3779b97f4a7c15ULL+(unsigned long long)iteration*0xc2b2ae3d27d4eb4fULL+stage;
+  x=(x^(x>>30))*0xbf58476d1ce4e5b9ULL;
+  x=(x^(x>>27))*0x94d049bb133111ebULL;
+  x^=x>>31;
+  return (int)(x&0x7fffffff);
+}
+
+/** file in the chain cache for the current chain, keyed by pattern, seed, size, number of accesses, alignment, and page size */
+static void chain_file_name(char *name, int len, unsigned long long memsize, volatile mydata_t *data)
+{
+  snprintf(name,len,"%s/chain_random_%08x_%llu_%i_%i_%i.bin",chain_cache_dir,random_start(memsize,0),memsize,accesses,alignment,data->pagesize);
+}
+
+/** starts recording the lines of a new pointer chain in a data set of size Byte (BENCHIT_KERNEL_FLUSH_TARGETED) */
+static void record_chain_start(unsigned long long size, unsigned long long num_lines)
+{
+  int l;
+
+  pthread_mutex_lock(&evict_lock);
+  if (num_lines>max_chain_lines){
+    chain_lines=(unsigned long long*)realloc(chain_lines,num_lines*sizeof(unsigned long long));
+    if (chain_lines==NULL){
+      fprintf( stderr, "Error: Allocation of the chain line list failed\n" ); fflush( stderr );
+      exit( 127 );
+    }
+    max_chain_lines=num_lines;
+  }
+  chain_size=size;
+  num_chain_lines=0;
+  for (l=0;l<EVICT_LEVELS;l++) chain_sets_valid[l]=0;
+  pthread_mutex_unlock(&evict_lock);
+}
+
+static inline void record_chain_line(unsigned long long addr)
+{
+  if (num_chain_lines<max_chain_lines) chain_lines[num_chain_lines++]=addr;
+}
+
+/** bookkeeping for node j at addr of a pointer chain that is being written
+ *  remembers where each sample starts (BENCHIT_KERNEL_SAMPLE_DURATION) and records the line (BENCHIT_KERNEL_FLUSH_TARGETED)
+ */
+static inline void chain_node(volatile mydata_t *data, unsigned long long j, unsigned long long addr)
+{
+  if ((data->sampling)&&(j%(24*data->sampling->passes)==0)) data->sampling->segments[j/(24*data->sampling->passes)]=addr;
+  if (data->settings&TARGETED_EVICTION) record_chain_line(addr);
+}
+
+/** writes the pointer chain from the chain cache into the buffer
+ *  the file is mapped read-only and the offsets are relocated to the address of the buffer
+ *  @return 1 if the chain was found in the cache, 0 otherwise
+ */
+static int load_chain(unsigned long long aligned_addr, unsigned long long memsize, volatile mydata_t *data)
+{
+  char name[4096];
+  chain_file_header_t *header;
+  unsigned long long *offsets,tmp_addr,next;
+  struct stat st;
+  size_t size;
+  int fd,j;
+
+  chain_file_name(name,sizeof(name),memsize,data);
+  fd=open(name,O_RDONLY);
+  if (fd==-1) return 0;
+  size=sizeof(chain_file_header_t)+accesses*sizeof(unsigned long long);
+  if ((fstat(fd,&st))||(st.st_size!=size)) {close(fd);return 0;}
+  header=(chain_file_header_t*)mmap(NULL,size,PROT_READ,MAP_PRIVATE,fd,0);
+  close(fd);
+  if (header==MAP_FAILED) return 0;
+  if ((memcmp(header->magic,"BILATCHN",8))||(header->version!=1)||(header->memsize!=memsize)||(header->accesses!=accesses)
+    ||(header->alignment!=alignment)||(header->pagesize!=data->pagesize)||(header->seed!=chain_seed)) {munmap(header,size);return 0;}
+  offsets=(unsigned long long*)(header+1);
+
+  tmp_addr=aligned_addr;
+  for(j=0;j<accesses;j++)
+  {
+    chain_node(data,j,tmp_addr);
+    next=aligned_addr+offsets[j];
+    __asm__ __volatile__(
+         "movnti %%rbx, (%%rax);"
+    :: "a" (tmp_addr), "b" (next) : "memory");
+    tmp_addr=next;
+  }
+  munmap(header,size);
+  return 1;
+}
+
+/** adds a pointer chain to the chain cache
+ *  the file is written under a temporary name and renamed, so concurrent threads do not see incomplete files
+ */
+static void store_chain(unsigned long long *offsets, unsigned long long memsize, volatile mydata_t *data)
+{
+  char name[4096],tmp_name[4200];
+  chain_file_header_t header;
+  size_t size;
+  int fd;
+
+  chain_file_name(name,sizeof(name),memsize,data);
+  snprintf(tmp_name,sizeof(tmp_name),"%s.%i.%lx",name,(int)getpid(),(unsigned long)pthread_self());
+  memset(&header,0,sizeof(header));
+  memcpy(header.magic,"BILATCHN",8);
+  header.version=1;
+  header.alignment=alignment;
+  header.memsize=memsize;
+  header.accesses=accesses;
+  header.pagesize=data->pagesize;
+  header.seed=chain_seed;
+  size=accesses*sizeof(unsigned long long);
+
+  fd=open(tmp_name,O_CREAT|O_WRONLY|O_TRUNC,0664);
+  if (fd==-1) return;
+  if ((write(fd,&header,sizeof(header))!=sizeof(header))||(write(fd,offsets,size)!=size)) {close(fd);unlink(tmp_name);return;}
+  close(fd);
+  if (rename(tmp_name,name)) unlink(tmp_name);
+}
+
+/** reads the pagemap entries of num_pages pages (4 KiB) starting at start
+ *  @return array of entries (bit 63: present, bits 0-54: PFN), NULL if the PFNs can not be read (requires CAP_SYS_ADMIN)
+ */
+static unsigned long long *read_pagemap(unsigned long long start, unsigned long long num_pages)
+{
+  unsigned long long *entries,i;
+  int fd,readable=0;
+
+  entries=(unsigned long long*)malloc(num_pages*sizeof(unsigned long long));
+  if (entries==NULL) return NULL;
+  fd=open("/proc/self/pagemap",O_RDONLY);
+  if ((fd==-1)||(pread(fd,entries,num_pages*sizeof(unsigned long long),(start/4096)*sizeof(unsigned long long))!=(ssize_t)(num_pages*sizeof(unsigned long long)))){
+    if (fd!=-1) close(fd);
+    free(entries);
+    return NULL;
+  }
+  close(fd);
+  for (i=0;i<num_pages;i++) if ((entries[i]>>63)&&(entries[i]&((1ULL<<55)-1))) readable=1;
+  if (!readable) {free(entries);return NULL;}
+  return entries;
+}
+
+/** physical address of addr, 0 if the page is not present */
+static inline unsigned long long pagemap_phys(unsigned long long *entries, unsigned long long start, unsigned long long addr)
+{
+  unsigned long long entry=entries[addr/4096-start/4096];
+
+  if (!(entry>>63)) return 0;
+  return (entry&((1ULL<<55)-1))*4096+addr%4096;
+}
+
+static inline unsigned int dram_bank(unsigned long long phys)
+{
+  unsigned int i,bank=0;
+
+  for (i=0;i<dram_num_functions;i++) bank|=__builtin_parityll(phys&dram_functions[i])<<i;
+  return bank;
+}
+
+/** writes a pointer chain that follows the DRAM address mapping into the buffer (BENCHIT_KERNEL_DRAM_MODE)
+ *  - DRAM_MODE_ROW_HIT: all elements are located in the row and bank of the first element
+ *  - DRAM_MODE_ROW_CONFLICT: all elements are located in the bank of the first element, consecutive elements in different rows
+ *  - DRAM_MODE_BANK_SPREAD: consecutive elements are located in different banks, the banks are used round robin
+ *  candidates are taken from the buffer in random order, accesses is reduced if not enough lines are found
+ *  @return 1 if a chain has been written, 0 if the random chain has to be used
+ */
+static int dram_chain(unsigned long long aligned_addr, unsigned long long memsize, volatile mydata_t *data)
+{
+  unsigned long long *entries,*lines,*queue=NULL,start,num_lines,first_phys,phys,addr,tmp_addr,last_row,n=0,cap=0,i,j;
+  unsigned int first_bank,bank,num_banks=1<<dram_num_functions,*queue_len=NULL;
+
+  start=aligned_addr&~4095ULL;
+  entries=read_pagemap(start,(aligned_addr+memsize-start+4095)/4096);
+  if (entries==NULL){
+    if (!dram_warned++) {fprintf( stderr, "Warning: physical addresses are not available, using random pointer chains\n" ); fflush( stderr );}
+    return 0;
+  }
+  first_phys=pagemap_phys(entries,start,aligned_addr);
+  first_bank=dram_bank(first_phys);
+  last_row=first_phys>>dram_row_shift;
+  num_lines=memsize/alignment;
+  lines=(unsigned long long*)malloc(accesses*sizeof(unsigned long long));
+  if (dram_mode==DRAM_MODE_BANK_SPREAD){
+    cap=accesses/num_banks+1;
+    queue=(unsigned long long*)malloc(num_banks*cap*sizeof(unsigned long long));
+    queue_len=(unsigned int*)calloc(num_banks,sizeof(unsigned int));
+  }
+  if ((first_phys==0)||(lines==NULL)||((dram_mode==DRAM_MODE_BANK_SPREAD)&&((queue==NULL)||(queue_len==NULL)))){
+    free(entries);free(lines);free(queue);free(queue_len);
+    return 0;
+  }
+
+  /* candidates in random order, the first line is implicitely selected */
+  _random_init(random_start(memsize,5),num_lines-1);
+  for (i=0;(i<num_lines-1)&&(n<accesses);i++){
+    addr=aligned_addr+((unsigned long long)_random()+1)*alignment;
+    phys=pagemap_phys(entries,start,addr);
+    if (phys==0) continue;
+    bank=dram_bank(phys);
+    switch (dram_mode){
+      case DRAM_MODE_ROW_HIT:
+        if ((bank==first_bank)&&((phys>>dram_row_shift)==(first_phys>>dram_row_shift))) lines[n++]=addr;
+        break;
+      case DRAM_MODE_ROW_CONFLICT:
+        if ((bank==first_bank)&&((phys>>dram_row_shift)!=last_row)) {lines[n++]=addr;last_row=phys>>dram_row_shift;}
+        break;
+      case DRAM_MODE_BANK_SPREAD:
+        if (queue_len[bank]<cap) {queue[bank*cap+queue_len[bank]]=addr;queue_len[bank]++;}
+        break;
+    }
+  }
+  /* round robin over the banks, starting with the bank after the first element */
+  if (dram_mode==DRAM_MODE_BANK_SPREAD){
+    bank=first_bank;
+    for (j=0;(n<accesses)&&(j<num_banks*cap);j++){
+      bank=(bank+1)%num_banks;
+      if (queue_len[bank]) lines[n++]=queue[bank*cap+(--queue_len[bank])];
+    }
+  }
+  free(entries);free(queue);free(queue_len);
+
+  n=(n/24)*24;
+  if (n==0){
+    if (!dram_warned++) {fprintf( stderr, "Warning: no suitable lines for the DRAM chain in %llu Byte, using random pointer chains\n",memsize ); fflush( stderr );}
+    free(lines);
+    return 0;
+  }
+  if (n<accesses){
+    if (!dram_warned++) {fprintf( stderr, "Warning: only %llu suitable lines for the DRAM chain in %llu Byte, reducing the number of accesses\n",n,memsize ); fflush( stderr );}
+    accesses=n;
+  }
+
+  tmp_addr=aligned_addr;
+  for (j=0;j<accesses;j++)
+  {
+    chain_node(data,j,tmp_addr);
+    __asm__ __volatile__(
+         "movnti %%rbx, (%%rax);"
+    :: "a" (tmp_addr), "b" (lines[j]) : "memory");
+    tmp_addr=lines[j];
+  }
+  free(lines);
+  return 1;
+}
+
+/** decisions within the emulated data structures (search path, probe and list lengths)
+ *  the sequence only depends on the data set size, so all threads use chains with the same number of accesses per node
+ */
+static inline unsigned long long structure_random(unsigned long long *x)
+{
+  *x^=*x<<13;
+  *x^=*x>>7;
+  *x^=*x<<17;
+  return *x;
+}
+
+/** threaddata of the thread that allocated the buffer containing addr, threaddata[0] for the buffer of the first thread
+ *  and threads without buffer of their own
+ */
+static volatile threaddata_t *buffer_owner(volatile mydata_t *data, unsigned long long addr)
+{
+  int t;
+
+  for (t=1;t<data->num_threads;t++){
+    if ((data->threaddata[t].buffer!=NULL)&&(addr>=(unsigned long long)data->threaddata[t].buffer)&&(addr<(unsigned long long)data->threaddata[t].buffer+data->threaddata[t].buffersize)) return &(data->threaddata[t]);
+  }
+  return &(data->threaddata[0]);
+}
+
+/** writes a pointer chain that emulates lookups in a linked data structure into the buffer (BENCHIT_KERNEL_STRUCTURE)
+ *  - the first element of the buffer is the root pointer, nodes, buckets, and table lines are used in random order
+ *  - STRUCTURE_BTREE_*: node with 4n-1 sorted keys followed by 4n child pointers (n cache lines), binary search
+ *    accesses each line that contains a compared key, followed by the line of the selected child pointer
+ *  - STRUCTURE_HASH_OPEN: linear probing in a table of 16 Byte entries, 1-4 probes (1.5 on average), the probes
+ *    continue in the adjacent line if they cross the line boundary
+ *  - STRUCTURE_HASH_CHAINED: 8 Byte bucket heads, followed by 1 or 2 list nodes of 32 Byte (load factor 1)
+ *  - STRUCTURE_TREE_AOS: search tree level with key and child pointers in one 32 Byte node
+ *  - STRUCTURE_TREE_SOA: search tree level with keys and child pointers in separate arrays (key, then child)
+ *  structure_hops of the buffer is set to the number of accesses per node (B-trees and search trees) or lookup (hash tables)
+ *  @return 1 if a chain has been written, 0 if the random chain has to be used
+ */
+static int structure_chain(unsigned long long aligned_addr, unsigned long long memsize, volatile mydata_t *data)
+{
+  volatile double *structure_hops=&(buffer_owner(data,aligned_addr)->structure_hops);
+  unsigned long long *lines,*nodes=NULL,x,tmp_addr,base,units,num_nodes=0,node_lines=1,num_keys,lo,hi,mid,line,touched;
+  unsigned long long n=0,hops=0,complete=0,next_node=0,used=0,i,j,p,s;
+
+  lines=(unsigned long long*)malloc((accesses+8)*sizeof(unsigned long long));
+  if (lines==NULL) return 0;
+  x=0x9e3779b97f4a7c15ULL^memsize;
+
+  switch (structure_mode){
+    case STRUCTURE_BTREE_64:
+    case STRUCTURE_BTREE_128:
+    case STRUCTURE_BTREE_256:
+    case STRUCTURE_BTREE_512:
+      node_lines=1ULL<<(structure_mode-STRUCTURE_BTREE_64);
+      units=memsize/(64*node_lines);
+      break;
+    case STRUCTURE_HASH_OPEN:
+      units=memsize/128;
+      break;
+    case STRUCTURE_HASH_CHAINED:
+      /* bucket array followed by the list nodes */
+      units=memsize/40;
+      num_nodes=(memsize-((units*8+63)&~63ULL))/32;
+      nodes=(unsigned long long*)malloc(num_nodes*sizeof(unsigned long long));
+      if ((nodes==NULL)||(num_nodes<2)) {free(lines);free(nodes);return 0;}
+      _random_init(random_start(memsize,7),num_nodes);
+      for (i=0;i<num_nodes;i++) nodes[i]=aligned_addr+((units*8+63)&~63ULL)+_random()*32;
+      break;
+    default:
+      units=memsize/32;
+      break;
+  }
+  if (units<2) {free(lines);free(nodes);return 0;}
+
+  /* unit 0 contains the root pointer */
+  _random_init(random_start(memsize,6),units-1);
+  while ((n<accesses)&&(used<units-1)){
+    base=(unsigned long long)_random()+1;used++;
+    switch (structure_mode){
+      case STRUCTURE_HASH_OPEN:
+        /* pair of adjacent lines, the second one is only used by probes that cross the line boundary */
+        base=aligned_addr+base*128;
+        s=structure_random(&x)&3;
+        for (p=1;(p<4)&&(structure_random(&x)%3==0);p++);
+        lines[n++]=base;
+        if (s+p>4) lines[n++]=base+64;
+        break;
+      case STRUCTURE_HASH_CHAINED:
+        lines[n++]=aligned_addr+base*8;
+        for (j=0;(j<1+(structure_random(&x)&1))&&(next_node<num_nodes);j++) lines[n++]=nodes[next_node++];
+        break;
+      case STRUCTURE_TREE_AOS:
+        lines[n++]=aligned_addr+base*32;
+        break;
+      case STRUCTURE_TREE_SOA:
+        /* keys[units] followed by children[2*units] */
+        lines[n++]=aligned_addr+base*8;
+        lines[n++]=aligned_addr+units*8+base*16;
+        break;
+      default:
+        base=aligned_addr+base*64*node_lines;
+        num_keys=4*node_lines-1;
+        lo=0;hi=num_keys;touched=0;
+        while (lo<hi){
+          mid=(lo+hi)/2;
+          line=(mid*8)/64;
+          if (!(touched&(1ULL<<line))) {lines[n++]=base+line*64;touched|=1ULL<<line;}
+          if (structure_random(&x)&1) lo=mid+1;
+          else hi=mid;
+        }
+        line=((num_keys+lo)*8)/64;
+        if (!(touched&(1ULL<<line))) lines[n++]=base+line*64;
+        break;
+    }
+    /* the last node or lookup is cut off */
+    if (n<=accesses) {complete++;hops=n;}
+  }
+  if (complete) *structure_hops=(double)hops/(double)complete;
+  else *structure_hops=1.0;
+  free(nodes);
+
+  if (n>accesses) n=accesses;
+  n=(n/24)*24;
+  if (n==0){
+    if (!structure_warned++) {fprintf( stderr, "Warning: %llu Byte are too small for BENCHIT_KERNEL_STRUCTURE, using random pointer chains\n",memsize ); fflush( stderr );}
+    *structure_hops=1.0;
+    free(lines);
+    return 0;
+  }
+  if (n<accesses){
+    if (!structure_warned++) {fprintf( stderr, "Warning: only %llu accesses fit into the data structure in %llu Byte, reducing the number of accesses\n",n,memsize ); fflush( stderr );}
+    accesses=n;
+  }
+
+  tmp_addr=aligned_addr;
+  for (j=0;j<accesses;j++)
+  {
+    chain_node(data,j,tmp_addr);
+    __asm__ __volatile__(
+         "movnti %%rbx, (%%rax);"
+    :: "a" (tmp_addr), "b" (lines[j]) : "memory");
+    tmp_addr=lines[j];
+  }
+  free(lines);
+  return 1;
+}
+
 /*
  * use a block of memory to ensure it is in the caches afterwards
  * MODE_EXCLUSIVE: - cache line will be exclusive in cache of calling CPU
@@ -316,12 +819,14 @@ static inline int use_memory(void* buffer,void* flush_buffer,unsigned long long
 {
    int i,j,tmp=0xd08a721b;
    unsigned long long stride = 64;
+   unsigned long long loop_addr,loop_count; /* registers that are modified by the assembler loops */
 
    /* additional variables for generation of unique random pattern during use_memory() prior to each call of asm_work() function */
    unsigned long long tmp_addr,tmp_offset,mask,max_accesses;
    unsigned long long usable_memory,num_pages,accesses_per_page,usable_page_size;
-   struct timeval time;
    unsigned long long aligned_addr;	   
+   unsigned long long *offsets=NULL;
+   int cached;
 
    aligned_addr=(unsigned long long)buffer;
 
@@ -352,37 +857,45 @@ static inline int use_memory(void* buffer,void* flush_buffer,unsigned long long
       accesses=(accesses/24)*24;
       if (accesses<=num_pages) {num_pages=accesses;usable_memory=num_pages*usable_page_size;/*alignment=usable_page_size;*/}
 
-      gettimeofday( &time, (struct timezone *) 0);
-      _random_init(time.tv_sec*time.tv_usec+pthread_self()*iteration*iteration,memsize/data->pagesize-1);
-      /* randomly select pages (4KB) - repetition free sequence returned by _random() 
-       * the first page is implicitely selected, as the asm_work() function is called with a pointer to the beginning of the buffer
-       */
-      data->page_address[0]=aligned_addr;tlb_check(aligned_addr,data); 
-      for (j=1;j<num_pages;j++)
-      {
-        /* select pages that fit into selected TLB level (BENCHIT_KERNEL_TLB_MODE) */
-        do{
-          data->page_address[j]=(((unsigned long long)_random()+1)*data->pagesize);
-        } while (tlb_check(aligned_addr+data->page_address[j],data));
-
-        if (threaddata!=NULL) threaddata->page_address[j]=data->page_address[j];
-        data->page_address[j]+=aligned_addr;
-        if (threaddata!=NULL) threaddata->page_address[j]+=threaddata->aligned_addr;
-      }  
+      /* chain cache (BENCHIT_KERNEL_CHAIN_CACHE_DIR), not used if the page selection depends on the TLB (BENCHIT_KERNEL_TLB_MODE) */
+      cached=(chain_cache_dir!=NULL)&&(chain_seed)&&(!((data->settings&RESTORE_TLB)&&(data->hugepages==HUGEPAGES_OFF)));
+      if (data->settings&TARGETED_EVICTION) record_chain_start(memsize,accesses);
+      /* chains that follow the DRAM address mapping (BENCHIT_KERNEL_DRAM_MODE) or emulate data structures (BENCHIT_KERNEL_STRUCTURE) are not cached */
+      if (((dram_mode==DRAM_MODE_OFF)||(!dram_chain(aligned_addr,memsize,data)))&&((structure_mode==STRUCTURE_OFF)||(!structure_chain(aligned_addr,memsize,data)))&&((!cached)||(!load_chain(aligned_addr,memsize,data)))){
+        if (cached) offsets=(unsigned long long*)malloc(accesses*sizeof(unsigned long long));
+        _random_init(random_start(memsize,1),memsize/data->pagesize-1);
+        /* randomly select pages (4KB) - repetition free sequence returned by _random() 
+         * the first page is implicitely selected, as the asm_work() function is called with a pointer to the beginning of the buffer
+         */
+        data->page_address[0]=aligned_addr;tlb_check(aligned_addr,data); 
+        for (j=1;j<num_pages;j++)
+        {
+          /* select pages that fit into selected TLB level (BENCHIT_KERNEL_TLB_MODE) */
+          do{
+            data->page_address[j]=(((unsigned long long)_random()+1)*data->pagesize);
+          } while (tlb_check(aligned_addr+data->page_address[j],data));
+
+          if (threaddata!=NULL) threaddata->page_address[j]=data->page_address[j];
+          data->page_address[j]+=aligned_addr;
+          if (threaddata!=NULL) threaddata->page_address[j]+=threaddata->aligned_addr;
+        }  
   
-      /* select random addresses within the choosen pages - repetition free sequence returned by _random() */
-      gettimeofday( &time, (struct timezone *) 0);
-      _random_init(time.tv_sec*time.tv_usec+pthread_self()*iteration*iteration,usable_memory/alignment-1);
-      tmp_addr=aligned_addr; 
-      for(j=0;j<accesses;j++)
-      {
-        tmp_offset=(((unsigned long long)_random())*alignment)+alignment;
-        //*((unsigned long long*)(tmp_addr))=data->page_address[tmp_offset/usable_page_size]+(tmp_offset%usable_page_size);
-        //changed to non-temporal store to prevent caching of the selected addresses
-        __asm__ __volatile__(
-             "movnti %%rbx, (%%rax);"
-        :: "a" (tmp_addr), "b" (data->page_address[tmp_offset/usable_page_size]+(tmp_offset%usable_page_size)));
-        tmp_addr=data->page_address[tmp_offset/usable_page_size]+(tmp_offset%usable_page_size);
+        /* select random addresses within the choosen pages - repetition free sequence returned by _random() */
+        _random_init(random_start(memsize,2),usable_memory/alignment-1);
+        tmp_addr=aligned_addr; 
+        for(j=0;j<accesses;j++)
+        {
+          chain_node(data,j,tmp_addr);
+          tmp_offset=(((unsigned long long)_random())*alignment)+alignment;
+          //*((unsigned long long*)(tmp_addr))=data->page_address[tmp_offset/usable_page_size]+(tmp_offset%usable_page_size);
+          //changed to non-temporal store to prevent caching of the selected addresses
+          __asm__ __volatile__(
+               "movnti %%rbx, (%%rax);"
+          :: "a" (tmp_addr), "b" (data->page_address[tmp_offset/usable_page_size]+(tmp_offset%usable_page_size)) : "memory");
+          tmp_addr=data->page_address[tmp_offset/usable_page_size]+(tmp_offset%usable_page_size);
+          if (offsets) offsets[j]=tmp_addr-aligned_addr;
+        }
+        if (offsets) {store_chain(offsets,memsize,data);free(offsets);}
       }
    }
    if ((data->extra_clflush)&&((mode==MODE_EXCLUSIVE)||(mode==MODE_MODIFIED)||(mode==MODE_INVALID))) {
@@ -399,25 +912,27 @@ static inline int use_memory(void* buffer,void* flush_buffer,unsigned long long
    {
      //invalidate remote caches
      //this kernel needs the content of the buffer, so the usage must not be destructive
+     loop_addr=(unsigned long long)buffer;loop_count=memsize/stride;
      __asm__ __volatile__(
-       		"_use_mem_inv_loop:"
+       		"1:"
        		"mov (%%rax), %%rbx;"
        		"mov %%rbx, (%%rax);"
        		"add %%rcx, %%rax;"
        		"sub $1, %%rdx;"
-       		"jnz _use_mem_inv_loop;"
-       		:: "a" ((unsigned long long)buffer), "b" (tmp), "c" (stride), "d" (memsize/stride) : "memory");
+       		"jnz 1b;"
+       		: "+a" (loop_addr), "+b" (tmp), "+d" (loop_count) : "c" (stride) : "memory");
 
      //invalidate local caches
      if (!cpuinfo.disable_clflush) clflush(buffer,memsize,cpuinfo);
      else {
+       loop_addr=(unsigned long long)flush_buffer;loop_count=((cpuinfo.D_Cache_Size_per_Core*cpuinfo.EXTRA_FLUSH_SIZE)/50)/stride;
        __asm__ __volatile__(
-       		"_use_mem_flush_loop:"
+       		"1:"
        		"mov %%rbx, (%%rax);"
        		"add %%rcx, %%rax;"
        		"sub $1, %%rdx;"
-       		"jnz _use_mem_flush_loop;"
-       		:: "a" ((unsigned long long)flush_buffer), "b" (tmp), "c" (stride), "d" (((cpuinfo.D_Cache_Size_per_Core*cpuinfo.EXTRA_FLUSH_SIZE)/50)/stride) : "memory");
+       		"jnz 1b;"
+       		: "+a" (loop_addr), "+d" (loop_count) : "b" (tmp), "c" (stride) : "memory");
        clflush(flush_buffer,(cpuinfo.D_Cache_Size_per_Core*cpuinfo.EXTRA_FLUSH_SIZE)/50,cpuinfo);
      }
    } 
@@ -433,25 +948,27 @@ static inline int use_memory(void* buffer,void* flush_buffer,unsigned long long
      {
        if (direction==FIFO){
          //this kernel needs the content of the buffer, so the usage must not be destructive
+         loop_addr=(unsigned long long)buffer;loop_count=memsize/stride;
          __asm__ __volatile__(
-       		"_use_mem_write_loop_fifo:"
+       		"1:"
        		"mov (%%rax), %%rbx;"
        		"mov %%rbx, (%%rax);"
        		"add %%rcx, %%rax;"
        		"sub $1, %%rdx;"
-       		"jnz _use_mem_write_loop_fifo;"
-       		:: "a" ((unsigned long long)buffer), "b" (tmp), "c" (stride), "d" (memsize/stride) : "memory");
+       		"jnz 1b;"
+       		: "+a" (loop_addr), "+b" (tmp), "+d" (loop_count) : "c" (stride) : "memory");
        }
        if (direction==LIFO){
          //this kernel needs the content of the buffer, so the usage must not be destructive
+         loop_addr=(unsigned long long)buffer+memsize;loop_count=memsize/stride;
          __asm__ __volatile__(
-       		"_use_mem_write_loop_lifo:"
+       		"1:"
        		"sub %%rcx, %%rax;"
        		"mov (%%rax), %%rbx;"
        		"mov %%rbx, (%%rax);"       		
        		"sub $1, %%rdx;"
-       		"jnz _use_mem_write_loop_lifo;"
-       		:: "a" ((unsigned long long)buffer+memsize), "b" (tmp), "c" (stride), "d" (memsize/stride) : "memory");
+       		"jnz 1b;"
+       		: "+a" (loop_addr), "+b" (tmp), "+d" (loop_count) : "c" (stride) : "memory");
        }
      }
    } 
@@ -461,22 +978,24 @@ static inline int use_memory(void* buffer,void* flush_buffer,unsigned long long
      while(j--)
      {
        if (direction==FIFO){
+         loop_addr=(unsigned long long)buffer;loop_count=memsize/stride;
          __asm__ __volatile__(
-       		"_use_mem_read_loop_fifo:"
+       		"1:"
        		"add (%%rax), %%rbx;"
        		"add %%rcx, %%rax;"
        		"sub $1, %%rdx;"
-       		"jnz _use_mem_read_loop_fifo;"
-       		: "=b" (tmp) : "a" ((unsigned long long)buffer), "c" (stride), "d" (memsize/stride));
+       		"jnz 1b;"
+       		: "+a" (loop_addr), "+b" (tmp), "+d" (loop_count) : "c" (stride) : "memory");
        }
        if (direction==LIFO) {
+         loop_addr=(unsigned long long)buffer+memsize;loop_count=memsize/stride;
          __asm__ __volatile__(
-       		"_use_mem_read_loop_lifo:"
+       		"1:"
        		"sub %%rcx, %%rax;"
        		"add (%%rax), %%rbx;"
        		"sub $1, %%rdx;"
-       		"jnz _use_mem_read_loop_lifo;"
-       		: "=b" (tmp) : "a" ((unsigned long long)buffer+memsize), "c" (stride), "d" (memsize/stride));
+       		"jnz 1b;"
+       		: "+a" (loop_addr), "+b" (tmp), "+d" (loop_count) : "c" (stride) : "memory");
        }
      }
    }  
@@ -576,6 +1095,134 @@ static inline int cacheflush(int level,int num_flushes,int mode,void* buffer,cpu
 }
 
 
+/* translation of virtual addresses via /proc/self/pagemap, the entry of the last page is kept */
+typedef struct pagemap_cache
+{
+   int fd;
+   int unreadable;                      /* set if present pages have PFN 0 (requires CAP_SYS_ADMIN) */
+   unsigned long long page_size,page,entry;
+} pagemap_cache_t;
+
+/** @return physical address of addr, 0 if the page is not present or the PFN can not be read */
+static unsigned long long phys_addr(pagemap_cache_t *pc, unsigned long long addr)
+{
+  unsigned long long pfn;
+
+  if (addr/pc->page_size!=pc->page){
+    pc->page=addr/pc->page_size;
+    if (pread(pc->fd,&(pc->entry),sizeof(pc->entry),pc->page*sizeof(unsigned long long))!=sizeof(pc->entry)) pc->entry=0;
+  }
+  /* bit 63: present, bits 0-54: PFN */
+  if (!(pc->entry>>63)) return 0;
+  pfn=pc->entry&((1ULL<<55)-1);
+  if (pfn==0) {pc->unreadable=1;return 0;}
+  return pfn*pc->page_size+addr%pc->page_size;
+}
+
+/** determines the number of sets, associativity, and line size of cache level l+1
+ *  @return 0 if the geometry is unknown
+ */
+static int evict_geometry(cpu_info_t *cpuinfo, int l, unsigned long long *sets, unsigned long long *ways, unsigned long long *line)
+{
+  if (l>=cpuinfo->Cachelevels) return 0;
+  *ways=cpuinfo->U_Cache_Sets[l]+cpuinfo->D_Cache_Sets[l];
+  *line=cpuinfo->Cacheline_size[l];
+  if ((*ways==0)||(*line==0)) return 0;
+  *sets=(cpuinfo->U_Cache_Size[l]+cpuinfo->D_Cache_Size[l])/(*ways*(*line));
+  return (*sets!=0);
+}
+
+/**
+ * evicts the lines of the last generated pointer chain from the cache levels up to level (BENCHIT_KERNEL_FLUSH_TARGETED)
+ * - for each set that contains such lines exactly ways lines of the flush buffer that map to the same set are accessed
+ * - all sets are evicted if the chain has another size (flushes of all caches) or has been generated by a helper process
+ * - sets are determined from physical addresses, L2 is evicted before L1
+ * the chain is shared by all threads, this relies on the data placement and the flushes being performed one after another
+ * @return 0 on success, -1 if the flush areas have to be used instead
+ */
+static int evict_lines(unsigned long long memsize,int level,int num_flushes,int mode,void* flush_buffer,cpu_info_t *cpuinfo)
+{
+  unsigned long long sets[EVICT_LEVELS],ways[EVICT_LEVELS],line[EVICT_LEVELS],count,addr,phys,s,w,i,stride,offset;
+  volatile int *p;
+  int l,all_sets,tmp=0x0fa38b09;
+  evict_table_t *table=NULL;
+  pagemap_cache_t pc;
+
+  if ((evict_disabled)||(level>EVICT_LEVELS)||(flush_buffer==NULL)) return -1;
+  for (l=0;l<level;l++) if (!evict_geometry(cpuinfo,l,&sets[l],&ways[l],&line[l])) return -1;
+
+  pthread_mutex_lock(&evict_lock);
+  pc.fd=open("/proc/self/pagemap",O_RDONLY);
+  pc.unreadable=0;
+  pc.page_size=sysconf(_SC_PAGESIZE);
+  pc.page=ULLONG_MAX;
+  if (pc.fd==-1) pc.unreadable=1;
+
+  /* conflict sets in the flush buffer, built on first use */
+  for (i=0;i<num_evict_tables;i++) if (evict_tables[i].flush_buffer==flush_buffer) table=&(evict_tables[i]);
+  if ((table==NULL)&&(num_evict_tables<EVICT_MAX_BUFFERS)){
+    table=&(evict_tables[num_evict_tables++]);
+    table->flush_buffer=flush_buffer;
+  }
+  for (l=0;(table!=NULL)&&(!pc.unreadable)&&(l<level);l++) if (table->lines[l]==NULL){
+    table->lines[l]=(unsigned long long*)calloc(sets[l]*ways[l],sizeof(unsigned long long));
+    if (table->lines[l]==NULL){
+      fprintf( stderr, "Error: Allocation of the eviction sets failed\n" ); fflush( stderr );
+      exit( 127 );
+    }
+    count=0;
+    /* only complete lines, the flush buffer size is not a multiple of the line size */
+    for (addr=(unsigned long long)flush_buffer;addr+line[l]<=(unsigned long long)flush_buffer+cpuinfo->Cacheflushsize;addr+=line[l]){
+      phys=phys_addr(&pc,addr);
+      if (phys==0) continue;
+      s=(phys/line[l])%sets[l];
+      for (w=0;w<ways[l];w++) if (table->lines[l][s*ways[l]+w]==0) {table->lines[l][s*ways[l]+w]=addr;count++;break;}
+    }
+    if (count<sets[l]*ways[l]) {fprintf( stderr, "Warning: flush buffer provides only %llu of %llu lines for the L%i eviction sets\n",count,sets[l]*ways[l],l+1 ); fflush( stderr );}
+  }
+
+  /* sets used by the chain, determined once per chain */
+  all_sets=((chain_size!=memsize)||(num_chain_lines==0));
+  for (l=0;(!all_sets)&&(!pc.unreadable)&&(l<level);l++) if (!chain_sets_valid[l]){
+    chain_sets[l]=(unsigned char*)realloc(chain_sets[l],sets[l]*sizeof(unsigned char));
+    if (chain_sets[l]==NULL){
+      fprintf( stderr, "Error: Allocation of the eviction sets failed\n" ); fflush( stderr );
+      exit( 127 );
+    }
+    memset(chain_sets[l],0,sets[l]*sizeof(unsigned char));
+    for (i=0;i<num_chain_lines;i++) if ((phys=phys_addr(&pc,chain_lines[i]))) chain_sets[l][(phys/line[l])%sets[l]]=1;
+    chain_sets_valid[l]=1;
+  }
+  if (pc.fd!=-1) close(pc.fd);
+
+  if ((pc.unreadable)||(table==NULL)){
+    if (pc.unreadable) fprintf( stderr, "Warning: physical addresses are not available, using flush areas instead of targeted eviction\n" );
+    else fprintf( stderr, "Warning: too many flush buffers, using flush areas instead of targeted eviction\n" );
+    fflush( stderr );
+    evict_disabled=1;
+    pthread_mutex_unlock(&evict_lock);
+    return -1;
+  }
+
+  /* num_flushes accesses per line as in cacheflush(), each pass accesses all conflict sets once
+   * MODE_MODIFIED writes the conflict lines, all other modes read them */
+  for (l=level-1;l>=0;l--){
+    stride=line[l]/(num_flushes>0?num_flushes:1);
+    if (stride<sizeof(int)) stride=sizeof(int);
+    for (offset=0;offset<line[l];offset+=stride) for (s=0;s<sets[l];s++) if ((all_sets)||(chain_sets[l][s])){
+      for (w=0;w<ways[l];w++){
+        if (table->lines[l][s*ways[l]+w]==0) break;
+        p=(volatile int*)(table->lines[l][s*ways[l]+w]+offset);
+        tmp|=*p;
+        if (mode==MODE_MODIFIED) *p=tmp;
+      }
+    }
+  }
+  pthread_mutex_unlock(&evict_lock);
+
+  return 0;
+}
+
 /*
  * flush all caches that are smaller than the specified memory size, including shared caches
  */
@@ -633,6 +1280,8 @@ static inline void flush_caches(void* buffer,unsigned long long memsize,int sett
    {   
      if ((settings&FLUSH(i))&&(memsize>(cpuinfo->U_Cache_Size[i-1]+cpuinfo->D_Cache_Size[i-1])))
      {
+       /* L1 and L2: conflict sets for the measured lines only (BENCHIT_KERNEL_FLUSH_TARGETED) */
+       if ((settings&TARGETED_EVICTION)&&(evict_lines(memsize,i,num_flushes,flush_mode,flush_buffer,cpuinfo)==0)) break;
        cacheflush(i,num_flushes,flush_mode,flush_buffer,*(cpuinfo));
        break;
      }
@@ -641,167 +1290,750 @@ static inline void flush_caches(void* buffer,unsigned long long memsize,int sett
 
 
 
-/* measure overhead of empty loop */
-int asm_loop_overhead(int n)
+/* initialize buffer (grows the initialized part to the given size) */
+void init_buffer(char *buffer, unsigned long long buffersize, unsigned long long *initialized, unsigned long long size, cpu_info_t *cpuinfo)
 {
-   unsigned long long a,b,c,d,i;
-   static unsigned long long ret=1000000;
+  unsigned long long i,tmp=sizeof(unsigned long long);
 
-   for (i=0;i<n;i++){
-        /* Output: RAX: stop timestamp 
-         *         RBX: start timestamp
-         */
-       __asm__ __volatile__(
-                "mov $1,%%rcx;"       
-                TIMESTAMP
-                SERIALIZE
-                "mov %%rax,%%rbx;"
-//                "jmp _work_loop_overhead;"
-//                ".align 64,0x0;"
-//                "_work_loop_overhead:"
-//                "sub $1,%%rcx;"
-//                "jnz _work_loop_overhead;"
-                SERIALIZE    
-                TIMESTAMP
-                : "=a" (a), "=b" (b), "=c" (c), "=d" (d)
-        );
-        if ((a-b)<ret) ret=(a-b);
-   }			
-  return (int)ret;
-}
-
-/** assembler implementation of latency measurement using mov instruction
+  /* whole hugepages, avoids touching the same page again for slightly larger sizes */
+  size=(size+(2*1024*1024-1))&0xffffffffffe00000ULL;
+  if (size>buffersize) size=buffersize;
+  if (size<=*initialized) return;
+
+  for (i=*initialized;i<=size-tmp;i+=tmp){
+     *((unsigned long long*)((unsigned long long)buffer+i))=(unsigned long long)i;
+  }
+  clflush(buffer+*initialized,size-*initialized,*cpuinfo);
+  *initialized=size;
+}
+
+/* events that can disturb a single run, see BENCHIT_KERNEL_NOISE_REJECTION */
+typedef struct noise_snapshot
+{
+   unsigned long long interrupts;       /* all interrupts of the involved CPUs except the local timer */
+   unsigned long long timer_interrupts; /* local timer interrupts (LOC) of the involved CPUs */
+   unsigned long long smis;             /* MSR_SMI_COUNT of the measuring CPU, 0 if not readable */
+   long vol_ctx_switches;
+   long invol_ctx_switches;
+} noise_snapshot_t;
+
+/* file descriptor of /dev/cpu/<measuring CPU>/msr (-2: not opened yet, -1: not available) */
+static int smi_msr_fd=-2;
+#define MSR_SMI_COUNT 0x34
+
+/** sums up the interrupts handled by up to two CPUs since boot
+ *  @param cpu0, cpu1 the CPUs to account interrupts for (may be identical)
+ *  @param snapshot interrupts and timer_interrupts are set
+ *  @return 0 if successful, -1 if /proc/interrupts could not be read
  */
-static int asm_work_mov(unsigned long long addr, unsigned long long passes,volatile mydata_t *data) __attribute__((noinline));
-static int asm_work_mov(unsigned long long addr, unsigned long long passes,volatile mydata_t *data)
+static int read_interrupts(int cpu0, int cpu1, noise_snapshot_t *snapshot)
 {
-   unsigned long long a,b;
-   int i;
+  FILE *f;
+  char *line=NULL,*p,*q;
+  size_t len=0;
+  int col,num_cols=0,col0=-1,col1=-1;
+  unsigned long long value,sum;
+
+  snapshot->interrupts=0;
+  snapshot->timer_interrupts=0;
+
+  f=fopen("/proc/interrupts","r");
+  if (f==NULL) return -1;
+
+  /* header line lists the online CPUs, offline CPUs are omitted, so column != CPU id */
+  if (getline(&line,&len,f)<0) {fclose(f);free(line);return -1;}
+  p=line;
+  while ((p=strstr(p,"CPU"))!=NULL){
+    p+=3;
+    if (atoi(p)==cpu0) col0=num_cols;
+    if (atoi(p)==cpu1) col1=num_cols;
+    num_cols++;
+  }
+  if (cpu1==cpu0) col1=-1;
+
+  while (getline(&line,&len,f)>=0){
+    p=strchr(line,':');
+    if (p==NULL) continue;
+    p++;
+    sum=0;
+    for (col=0;col<num_cols;col++){
+      value=strtoull(p,&q,10);
+      if (q==p) break; /* e.g. ERR and MIS only have a single column */
+      if ((col==col0)||(col==col1)) sum+=value;
+      p=q;
+    }
+    if (strstr(line,"LOC:")!=NULL) snapshot->timer_interrupts+=sum;
+    else snapshot->interrupts+=sum;
+  }
+  free(line);
+  fclose(f);
 
-   if (!passes) return 0;
+  return 0;
+}
 
-   #ifdef USE_PAPI
-    if (data->num_events) PAPI_reset(data->Eventset);
-   #endif
+/** reads the counters that are compared by noise_detected()
+ *  @param measuring_cpu CPU that performs the measurement
+ *  @param data_cpu CPU whose caches hold the data
+ */
+static void take_noise_snapshot(int measuring_cpu, int data_cpu, noise_snapshot_t *snapshot)
+{
+  struct rusage usage;
+  char path[64];
 
+  read_interrupts(measuring_cpu,data_cpu,snapshot);
 
-     /*
-      * Input:  RBX: addr (pointer to the buffer)
-      *         RCX: passes (number of loop iterations)
-      * Output: RAX: stop timestamp
-      *         RBX: start timestamp
-      */
-     __asm__ __volatile__(
-                TIMESTAMP
-                SERIALIZE
-/* standard version */
-                "jmp _work_loop_mov_1;"
-                ".align 64,0x0;"
-                //loop that performs random memory accesses (memory contains precalculated random target addresses)
-                "_work_loop_mov_1:"
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "mov (%%rbx), %%rbx;"NOP(NOPCOUNT)
-                "sub $1,%%rcx;"
-                "jnz _work_loop_mov_1;"
-
-
-                SERIALIZE
-                "mov %%rax,%%rbx;"
-                TIMESTAMP
-                : "=a" (a),"=b" (b)
-                : "b"(addr), "c" (passes)
-                : "%rdx", "%r8", "%r9", "%r10", "%r11", "%r12", "%r13", "%r14", "%r15"
-
-     );
-  #ifdef USE_PAPI
-    if (data->num_events) PAPI_read(data->Eventset,data->values);
-  #endif
-    return (unsigned int) ((a-b)-data->cpuinfo->rdtsc_latency)/(passes*24);
+  /* SMIs are not listed in /proc/interrupts, MSR 0x34 counts them on Intel CPUs (requires msr module and root) */
+  if (smi_msr_fd==-2){
+    sprintf(path,"/dev/cpu/%i/msr",measuring_cpu);
+    smi_msr_fd=open(path,O_RDONLY);
+    if (smi_msr_fd<0) {smi_msr_fd=-1;printf("  noise rejection: %s not readable, SMIs will not be detected\n",path);fflush(stdout);}
+  }
+  snapshot->smis=0;
+  if ((smi_msr_fd>=0)&&(pread(smi_msr_fd,&(snapshot->smis),sizeof(unsigned long long),MSR_SMI_COUNT)!=sizeof(unsigned long long))) snapshot->smis=0;
+
+  /* only the measuring thread, switches of the SMT load, sweep or wake-up threads do not disturb the measurement */
+  getrusage(RUSAGE_THREAD,&usage);
+  snapshot->vol_ctx_switches=usage.ru_nvcsw;
+  snapshot->invol_ctx_switches=usage.ru_nivcsw;
 }
 
-/** function that performs the measurement
- *   - entry point for BenchIT framework (called by bi_entry())
+/** checks if anything happened between two snapshots that could have disturbed the run
+ *  @param mode NOISE_REJECTION_ON: local timer interrupts are ignored, they occur periodically during the data placement
+ *                                  of large data sets and would reject every run
+ *              NOISE_REJECTION_STRICT: local timer interrupts are not ignored (CPUs with nohz_full)
+ *  @return 1 if the run was disturbed, 0 otherwise
  */
-void _work(unsigned long long memsize, int def_alignment, int offset, int function, int num_accesses, int runs, volatile mydata_t* data, double **results)
+static int noise_detected(noise_snapshot_t *before, noise_snapshot_t *after, int mode)
 {
-  int i,j,k,t,tmax,max_threads;
-  unsigned long long tmp,tmp2,tmp3,mask;
-  
-  unsigned long long usable_memory,num_pages,accesses_per_page,usable_page_size;
-	
-  unsigned long long tmp_addr,tmp_offset,max_accesses;	
+  if (after->interrupts!=before->interrupts) return 1;
+  if ((mode==NOISE_REJECTION_STRICT)&&(after->timer_interrupts!=before->timer_interrupts)) return 1;
+  if (after->smis!=before->smis) return 1;
+  if (after->vol_ctx_switches!=before->vol_ctx_switches) return 1;
+  if (after->invol_ctx_switches!=before->invol_ctx_switches) return 1;
+  return 0;
+}
 
-  /* aligned address */
-  unsigned long long aligned_addr;
+/** lets another thread access a buffer with the given use mode (see USE MODE ADAPTION)
+ *  @param id thread that accesses the memory
+ *  @param addr buffer that is accessed instead of the thread's own buffer
+ */
+static void use_memory_on_thread(volatile mydata_t *data, int id, unsigned long long addr, unsigned long long memsize, int mode)
+{
+  unsigned long long tmp;
+
+  tmp=data->threaddata[id].aligned_addr;
+  data->threaddata[id].aligned_addr=addr;
+  data->threaddata[id].memsize=memsize;
+  data->threaddata[id].accesses=accesses;
+  data->threaddata[id].USE_MODE=mode;
+  __asm__ __volatile__("mfence;"::: "memory");
+
+  data->thread_comm[id]=THREAD_USE_MEMORY;
+  while (!data->ack);
+  data->ack=0;
+  data->thread_comm[id]=THREAD_WAIT;
+  //wait for other thread using the memory
+  while (!data->ack);
+  data->ack=0;
+  while (!data->done);
+  data->done=0;
+  data->threaddata[id].aligned_addr=tmp;
+}
 
+/** lets the last BENCHIT_KERNEL_CONCURRENT_READERS CPUs from SHARED_CPU_LIST follow the pointer chain in addr
+ *  concurrently to the measurement, they start as soon as data->start is set
+ */
+static void start_concurrent_readers(volatile mydata_t *data, unsigned long long addr)
+{
+  int i;
 
-  struct timeval time;
-  
-  gettimeofday( &time, (struct timezone *) 0);
+  for (i=data->FRST_SHARE_CPU+data->NUM_SHARED_CPUS-data->CONCURRENT_READERS;i<data->FRST_SHARE_CPU+data->NUM_SHARED_CPUS;i++){
+    data->threaddata[i].read_addr=addr;
+    data->threaddata[i].accesses=accesses;
+    __asm__ __volatile__("mfence;"::: "memory");
+    data->thread_comm[i]=THREAD_READ_CONCURRENT;
+    while (!data->ack);
+    data->ack=0;
+  }
+  data->start=1;
+  __asm__ __volatile__("mfence;"::: "memory");
+}
 
- 
-  /* use rdtsc latency parameter for loop overhead compensation */
-  if ((data->settings)&LOOP_OVERHEAD_COMP) data->cpuinfo->rdtsc_latency=data->loop_overhead;
-  
-  /* calculate aligned address*/
-  aligned_addr = (unsigned long long)(data->buffer)+offset;
-  
-  accesses=num_accesses;
-  alignment=def_alignment;
+/** waits until all concurrent readers have finished
+ *  @return number of readers that started after the end of the measurement and did not read
+ */
+static int stop_concurrent_readers(volatile mydata_t *data)
+{
+  int i,late=0;
+
+  data->start=0;
+  for (i=data->FRST_SHARE_CPU+data->NUM_SHARED_CPUS-data->CONCURRENT_READERS;i<data->FRST_SHARE_CPU+data->NUM_SHARED_CPUS;i++){
+    data->thread_comm[i]=THREAD_WAIT;
+    while (!data->ack);
+    data->ack=0;
+    if (!data->threaddata[i].read_addr) late++;
+  }
+  return late;
+}
 
-  mask=(data->pagesize-1)^0xffffffffffffffffULL;
-  usable_memory=(memsize&mask);
-  usable_page_size=data->pagesize;
+/* reads the timestamp counter */
+static inline unsigned long long read_tsc(void)
+{
+  unsigned long long a,d;
 
-  if ((data->settings&RESTORE_TLB)&&(data->hugepages==HUGEPAGES_OFF))
-  {
-    usable_memory=usable_memory/2;
-    usable_page_size=(data->pagesize)/2;
-    if (usable_memory>data->tlb_size*(data->pagesize/2)) usable_memory=data->tlb_size*(data->pagesize/2);
-    reset_tlb_check(data);
+  __asm__ __volatile__(TIMESTAMP : "=a" (a), "=d" (d));
+  return a;
+}
+
+static int compare_ull(const void *a, const void *b)
+{
+  if (*((unsigned long long*)a)<*((unsigned long long*)b)) return -1;
+  if (*((unsigned long long*)a)>*((unsigned long long*)b)) return 1;
+  return 0;
+}
+
+/** time-series sampling (BENCHIT_KERNEL_SAMPLE_DURATION): runs short measurements back-to-back until the duration has elapsed
+ *  and writes them to the sample file, the prepared coherency state only applies to the first sample
+ *  each sample follows the next segment of the pointer chain, the last segment is followed by the first one again
+ *  @param addr start of the pointer chain
+ *  @param cpu CPU that holds the data (stored in the samples)
+ *  @return latency of the first sample
+ */
+static int take_samples(volatile mydata_t *data, unsigned long long addr, unsigned int cpu)
+{
+  sampling_t *sampling=data->sampling;
+  unsigned long long passes,num_segments,segment,end;
+  sample_t *sample;
+
+  passes=sampling->passes;
+  if (passes>accesses/24) passes=accesses/24;
+  num_segments=accesses/(24*passes);
+  sampling->segments[0]=addr;
+  sampling->num_samples=0;
+
+  end=read_tsc()+sampling->duration;
+  segment=0;
+  do{
+    if (sampling->num_samples==sampling->max_samples){
+      printf("  Warning: sample buffer full (BENCHIT_KERNEL_SAMPLE_MAX), time series of CPU%u truncated\n",cpu);fflush(stdout);
+      break;
+    }
+    sample=&(sampling->samples[sampling->num_samples++]);
+    sample->tsc=read_tsc();
+    sample->cycles=asm_work_mov(sampling->segments[segment],passes,data);
+    sample->cpu=cpu;
+    if (++segment==num_segments) segment=0;
   }
+  while(sample->tsc<end);
 
-  max_accesses=(usable_memory/alignment);
-  if (max_accesses<accesses) accesses=max_accesses;
-  num_pages=usable_memory/usable_page_size;
-  accesses=(accesses/24)*24;
+  if (write(sampling->fd,sampling->samples,sampling->num_samples*sizeof(sample_t))!=sampling->num_samples*sizeof(sample_t)){
+    fprintf( stderr, "Error: could not write sample file\n" ); fflush( stderr );
+    exit( 1 );
+  }
 
-  data->page_address=(unsigned long long*)realloc(data->page_address,num_pages*sizeof(unsigned long long));
-  for (t=1;t<data->num_threads;t++) data->threaddata[t].page_address=(unsigned long long*)realloc(data->threaddata[t].page_address,num_pages*sizeof(unsigned long long));
+  return sampling->samples[0].cycles;
+}
 
-  if (accesses<=num_pages) {num_pages=accesses;usable_memory=num_pages*usable_page_size;/*alignment=usable_page_size;*/}
+/** first-touch latency (BENCHIT_KERNEL_PAGE_FAULT_MODE): maps fresh anonymous memory and writes to every 4 KiB of it once
+ *  the duration includes mmap() and madvise(), so pre-faulting with MAP_POPULATE or MADV_WILLNEED is accounted for
+ *  results are stored in threaddata->fault_latency (cycles per page) and threaddata->fault_duration (cycles for memsize),
+ *  both are 0 if the memory could not be mapped
+ */
+static void page_fault_latency(unsigned long long memsize, int mode, threaddata_t *threaddata)
+{
+  unsigned long long pagesize,num_pages,map_size,start,i,j;
+  int flags=MAP_PRIVATE|MAP_ANONYMOUS;
+  char *buffer;
+  volatile char *addr;
+
+  threaddata->fault_latency=0;
+  threaddata->fault_duration=0;
+
+  if ((mode==PAGE_FAULT_THP)||(mode==PAGE_FAULT_HUGETLB)) pagesize=HUGEPAGE_SIZE;
+  else pagesize=4096;
+  num_pages=memsize/pagesize;
+  if (num_pages==0) return;
+  map_size=num_pages*pagesize;
+  if (mode==PAGE_FAULT_HUGETLB) flags|=MAP_HUGETLB;
+  if (mode==PAGE_FAULT_POPULATE) flags|=MAP_POPULATE;
+  /* THP requires 2 MiB aligned memory */
+  if (mode==PAGE_FAULT_THP) map_size+=pagesize;
+
+  start=read_tsc();
+  buffer=(char*)mmap(NULL,map_size,PROT_READ|PROT_WRITE,flags,-1,0);
+  if (buffer==MAP_FAILED) return;
+  addr=buffer;
+  if (mode==PAGE_FAULT_THP){
+    addr=(char*)(((unsigned long long)buffer+pagesize-1)&~(pagesize-1));
+    madvise((void*)addr,num_pages*pagesize,MADV_HUGEPAGE);
+  }
+  if (mode==PAGE_FAULT_WILLNEED) madvise((void*)addr,num_pages*pagesize,MADV_WILLNEED);
+  for (i=0;i<num_pages*pagesize;i+=pagesize){
+    for (j=0;j<pagesize;j+=4096) addr[i+j]=1;
+  }
+  threaddata->fault_duration=read_tsc()-start;
+  threaddata->fault_latency=threaddata->fault_duration/num_pages;
 
+  munmap(buffer,map_size);
+}
 
-  if ((accesses<=48) && (memsize<data->cpuinfo->Total_D_Cache_Size)) runs*=2;
-  if ((accesses<=120) && (memsize<data->cpuinfo->Total_D_Cache_Size)) runs*=2;
-  if (memsize>data->cpuinfo->Total_D_Cache_Size) runs/=3;
-  if (runs==0) runs=1;
+/** measures the first-touch latency on all selected CPUs, reports the maximum of all runs
+ *  (*results)[t] is the latency per page, data->fault_results[t] the duration per GiB in cycles
+ */
+static void work_page_faults(unsigned long long memsize, int runs, volatile mydata_t *data, double **results)
+{
+  int i,t;
+  unsigned long long tmax,duration,pagesize;
+  threaddata_t *threaddata;
+
+  if ((data->PAGE_FAULT_MODE==PAGE_FAULT_THP)||(data->PAGE_FAULT_MODE==PAGE_FAULT_HUGETLB)) pagesize=HUGEPAGE_SIZE;
+  else pagesize=4096;
+
+  for (t=0;t<data->num_results;t++){
+    threaddata=(threaddata_t*)&(data->threaddata[t]);
+    tmax=0;duration=0;
+    for (i=0;i<runs;i++){
+      if (!t) page_fault_latency(memsize,data->PAGE_FAULT_MODE,threaddata);
+      else {
+        threaddata->memsize=memsize;
+        __asm__ __volatile__("mfence;"::: "memory");
+        data->thread_comm[t]=THREAD_PAGE_FAULT;
+        while (!data->ack);
+        data->ack=0;
+        data->thread_comm[t]=THREAD_WAIT;
+        //wait for other thread touching the memory
+        while (!data->ack);
+        data->ack=0;
+        while (!data->done);
+        data->done=0;
+      }
+      if (threaddata->fault_latency>tmax){
+        tmax=threaddata->fault_latency;
+        duration=threaddata->fault_duration;
+      }
+    }
+    if (duration){
+      (*results)[t]=(double)tmax;
+      data->fault_results[t]=(double)duration*(1024.0*1024.0*1024.0)/(double)((memsize/pagesize)*pagesize);
+    }
+    else {
+      if (memsize>=pagesize) {printf("  Warning: mmap() of %llu Byte failed on CPU%u\n",memsize,threaddata->cpu_id);fflush(stdout);}
+      (*results)[t]=INVALID_MEASUREMENT;
+      data->fault_results[t]=INVALID_MEASUREMENT;
+    }
+  }
+}
+
+/** instruction fetch latency (BENCHIT_KERNEL_CODE_LATENCY): maps executable memory of the given size and links all its
+ *  cachelines in random order with jmp instructions, the chain is executed once to place it in the caches (or to evict
+ *  it to memory if it is too large) and once more for the measurement (at least accesses jumps)
+ *  the result is stored in threaddata->code_latency (cycles per jump), 0 if the memory could not be mapped
+ */
+static void code_latency(unsigned long long memsize, unsigned long long accesses, int mode, volatile mydata_t *data, threaddata_t *threaddata)
+{
+  unsigned long long pagesize,map_size,num_lines,start,addr,next,j;
+  int flags=MAP_PRIVATE|MAP_ANONYMOUS;
+  char *buffer;
+
+  threaddata->code_latency=0;
+
+  if (mode==CODE_LATENCY_4K) pagesize=4096;
+  else pagesize=HUGEPAGE_SIZE;
+  num_lines=memsize/STRIDE;
+  if (num_lines<2) return;
+  map_size=((memsize+pagesize-1)/pagesize)*pagesize;
+  if (mode==CODE_LATENCY_HUGETLB) flags|=MAP_HUGETLB;
+  /* THP requires 2 MiB aligned memory */
+  if (mode==CODE_LATENCY_THP) map_size+=pagesize;
+
+  buffer=(char*)mmap(NULL,map_size,PROT_READ|PROT_WRITE,flags,-1,0);
+  if (buffer==MAP_FAILED) return;
+  start=(unsigned long long)buffer;
+  if (mode==CODE_LATENCY_THP){
+    start=(start+pagesize-1)&~(pagesize-1);
+    madvise((void*)start,map_size-pagesize,MADV_HUGEPAGE);
+  }
+
+  /* jmp rel32 (0xe9) from each selected cacheline to the next, ret (0xc3) in the last one
+   * the first cacheline is implicitely selected, _random() returns a repetition free sequence of the others */
+  _random_init(random_start(memsize,3),num_lines-1);
+  addr=start;
+  for (j=1;j<num_lines;j++){
+    next=start+(_random()+1)*STRIDE;
+    *((unsigned char*)addr)=0xe9;
+    *((int*)(addr+1))=(int)(next-(addr+5));
+    addr=next;
+  }
+  *((unsigned char*)addr)=0xc3;
+
+  if (mprotect(buffer,map_size,PROT_READ|PROT_EXEC)==0){
+    /* remove the code from the data caches before it is executed */
+    clflush((void*)start,num_lines*STRIDE,*(data->cpuinfo));
+    asm_work_jmp(start,1,num_lines,data);
+    threaddata->code_latency=asm_work_jmp(start,(accesses+num_lines-1)/num_lines,num_lines,data);
+    /* 0 is reserved for failed measurements */
+    if (threaddata->code_latency==0) threaddata->code_latency=1;
+  }
+
+  munmap(buffer,map_size);
+}
+
+/** measures the instruction fetch latency on all selected CPUs, reports the maximum of all runs
+ *  (*results)[t] is the latency per jump in cycles
+ */
+static void work_code_latency(unsigned long long memsize, unsigned long long accesses, int runs, volatile mydata_t *data, double **results)
+{
+  int i,t;
+  unsigned long long tmax;
+  threaddata_t *threaddata;
+
+  for (t=0;t<data->num_results;t++){
+    threaddata=(threaddata_t*)&(data->threaddata[t]);
+    tmax=0;
+    for (i=0;i<runs;i++){
+      iteration=i;
+      if (!t) code_latency(memsize,accesses,data->CODE_LATENCY,data,threaddata);
+      else {
+        threaddata->memsize=memsize;
+        threaddata->accesses=accesses;
+        __asm__ __volatile__("mfence;"::: "memory");
+        data->thread_comm[t]=THREAD_CODE_LATENCY;
+        while (!data->ack);
+        data->ack=0;
+        data->thread_comm[t]=THREAD_WAIT;
+        //wait for other thread executing the code
+        while (!data->ack);
+        data->ack=0;
+        while (!data->done);
+        data->done=0;
+      }
+      if (threaddata->code_latency>tmax) tmax=threaddata->code_latency;
+    }
+    if (tmax) (*results)[t]=(double)tmax;
+    else {
+      if (memsize>=2*STRIDE) {printf("  Warning: mapping %llu Byte of executable memory failed on CPU%u\n",memsize,threaddata->cpu_id);fflush(stdout);}
+      (*results)[t]=INVALID_MEASUREMENT;
+    }
+  }
+}
+
+/** target side of the wake-up latency measurement (BENCHIT_KERNEL_WAKEUP_MODE): blocks wakeup_samples times and stores
+ *  the time from the wake-up request of the first CPU until this thread runs again (cycles, the TSC is synchronized)
+ */
+static void wakeup_target(void)
+{
+  unsigned long long value;
+  char c;
+  int i;
+
+  for (i=0;i<wakeup_samples;i++){
+    wakeup_word=0;
+    __asm__ __volatile__("mfence;"::: "memory");
+    wakeup_ready=1;
+    switch (wakeup_mode){
+      case WAKEUP_FUTEX:
+        while (!wakeup_word) syscall(SYS_futex,&wakeup_word,FUTEX_WAIT_PRIVATE,0,NULL,NULL,0);
+        break;
+      case WAKEUP_EVENTFD:
+        while (read(wakeup_fd[0],&value,sizeof(value))!=sizeof(value));
+        break;
+      case WAKEUP_PIPE:
+        while (read(wakeup_fd[0],&c,1)!=1);
+        break;
+    }
+    wakeup_latency[i]=read_tsc()-wakeup_send;
+  }
+}
+
+/** source side: waits until the target is about to block, keeps it idle for idle_cycles, and wakes it */
+static void wakeup_source(unsigned long long idle_cycles)
+{
+  unsigned long long value=1,start;
+  char c=0;
+  int i;
+
+  for (i=0;i<wakeup_samples;i++){
+    while (!wakeup_ready);
+    wakeup_ready=0;
+    start=read_tsc();
+    while (read_tsc()-start<idle_cycles);
+    wakeup_send=read_tsc();
+    __asm__ __volatile__("mfence;"::: "memory");
+    switch (wakeup_mode){
+      case WAKEUP_FUTEX:
+        wakeup_word=1;
+        syscall(SYS_futex,&wakeup_word,FUTEX_WAKE_PRIVATE,1,NULL,NULL,0);
+        break;
+      case WAKEUP_EVENTFD:
+        if (write(wakeup_fd[1],&value,sizeof(value))!=sizeof(value)) {fprintf( stderr, "Error: write to eventfd failed\n" ); fflush( stderr ); exit( 127 );}
+        break;
+      case WAKEUP_PIPE:
+        if (write(wakeup_fd[1],&c,1)!=1) {fprintf( stderr, "Error: write to pipe failed\n" ); fflush( stderr ); exit( 127 );}
+        break;
+    }
+  }
+}
+
+/** wake-up latency from the first CPU to all other selected CPUs after an idle period of idle_ns
+ *  (*results)[t] is the median, wakeup_percentiles the 90th and 99th percentile and the maximum in cycles
+ */
+static void work_wakeup(unsigned long long idle_ns, volatile mydata_t *data, double **results)
+{
+  unsigned long long idle_cycles;
+  int t,n=wakeup_samples;
+
+  if (wakeup_latency==NULL){
+    wakeup_latency=(unsigned long long*)malloc(n*sizeof(unsigned long long));
+    if (wakeup_latency==NULL) {fprintf( stderr, "Error: Allocation of the wake-up latencies failed\n" ); fflush( stderr ); exit( 127 );}
+    if (wakeup_mode==WAKEUP_EVENTFD){
+      wakeup_fd[0]=eventfd(0,0);
+      wakeup_fd[1]=wakeup_fd[0];
+      if (wakeup_fd[0]<0) {fprintf( stderr, "Error: eventfd() failed\n" ); fflush( stderr ); exit( 127 );}
+    }
+    if ((wakeup_mode==WAKEUP_PIPE)&&(pipe(wakeup_fd))) {fprintf( stderr, "Error: pipe() failed\n" ); fflush( stderr ); exit( 127 );}
+  }
+  idle_cycles=(unsigned long long)((double)idle_ns*data->cpuinfo->clockrate/1000000000.0);
+
+  /* the first CPU is the source */
+  (*results)[0]=INVALID_MEASUREMENT;
+  wakeup_percentiles[0]=INVALID_MEASUREMENT;
+  wakeup_percentiles[data->num_results]=INVALID_MEASUREMENT;
+  wakeup_percentiles[2*data->num_results]=INVALID_MEASUREMENT;
+
+  for (t=1;t<data->num_results;t++){
+    wakeup_ready=0;
+    __asm__ __volatile__("mfence;"::: "memory");
+    data->thread_comm[t]=THREAD_WAKEUP;
+    while (!data->ack);
+    data->ack=0;
+    data->thread_comm[t]=THREAD_WAIT;
+    wakeup_source(idle_cycles);
+    //wait for other thread returning from the last wake-up
+    while (!data->ack);
+    data->ack=0;
+    while (!data->done);
+    data->done=0;
+
+    qsort(wakeup_latency,n,sizeof(unsigned long long),compare_ull);
+    (*results)[t]=(double)wakeup_latency[n/2];
+    wakeup_percentiles[t]=(double)wakeup_latency[(n*90)/100];
+    wakeup_percentiles[data->num_results+t]=(double)wakeup_latency[(n*99)/100];
+    wakeup_percentiles[2*data->num_results+t]=(double)wakeup_latency[n-1];
+  }
+}
+
+/** local latency measured on a sweep CPU (BENCHIT_KERNEL_SWEEP_CPU_LIST), runs concurrently with the master thread
+ *  _random() and use_memory() use global state, so the pointer chain is generated with rand_r() and placed in the
+ *  private caches with use mode EXCLUSIVE or MODIFIED like in use_memory()
+ *  the result is stored in mydata->sweep_latency (cycles), 0 if the measurement failed
+ */
+static void sweep_latency(volatile mydata_t *data, threaddata_t *mydata)
+{
+  unsigned long long memsize=mydata->memsize,num_lines,num_accesses,addr,next,i,j,tmax;
+  unsigned int *lines,seed,k;
+  int runs=mydata->sweep_runs,run,tmp;
+
+  mydata->sweep_latency=0;
+  mydata->aligned_addr=(unsigned long long)(mydata->buffer)+mydata->offset;
+  num_lines=memsize/mydata->sweep_alignment;
+  num_accesses=mydata->accesses;
+  if (num_accesses>num_lines) num_accesses=num_lines;
+  num_accesses=(num_accesses/24)*24;
+  if (num_accesses<24) return;
+  lines=(unsigned int*)malloc(num_lines*sizeof(unsigned int));
+  if (lines==NULL) return;
+
+  /* same number of runs as in _work() */
+  if ((num_accesses<=48) && (memsize<mydata->cpuinfo->Total_D_Cache_Size)) runs*=2;
+  if ((num_accesses<=120) && (memsize<mydata->cpuinfo->Total_D_Cache_Size)) runs*=2;
+  if (memsize>mydata->cpuinfo->Total_D_Cache_Size) runs/=3;
+  if (runs==0) runs=1;
+
+  seed=random_start(memsize,4)+mydata->thread_id;
+  tmax=0;
+  for (run=0;run<runs;run++){
+    /* random selection of num_accesses cachelines, the first one is implicitely selected */
+    memset((void*)mydata->aligned_addr,0,memsize);
+    for (i=0;i<num_lines;i++) lines[i]=i;
+    addr=mydata->aligned_addr;
+    for (i=1;i<num_accesses;i++){
+      j=i+rand_r(&seed)%(num_lines-i);
+      k=lines[i];lines[i]=lines[j];lines[j]=k;
+      next=mydata->aligned_addr+(unsigned long long)lines[i]*mydata->sweep_alignment;
+      *((unsigned long long*)addr)=next;
+      addr=next;
+    }
+    clflush((void*)mydata->aligned_addr,memsize,*(mydata->cpuinfo));
+    __asm__ __volatile__("mfence;"::: "memory");
+
+    /* data placement, reads the buffer (EXCLUSIVE) or reads and writes it (MODIFIED) */
+    for (j=0;j<mydata->NUM_USES;j++){
+      for (i=0;i<memsize;i+=STRIDE){
+        next=*((volatile unsigned long long*)(mydata->aligned_addr+i));
+        if (mydata->USE_MODE==MODE_MODIFIED) *((volatile unsigned long long*)(mydata->aligned_addr+i))=next;
+      }
+    }
+    __asm__ __volatile__("mfence;"::: "memory");
+    flush_caches((void*)mydata->aligned_addr,memsize,mydata->settings,mydata->NUM_FLUSHES,mydata->FLUSH_MODE,mydata->cache_flush_area,mydata->cpuinfo);
+
+    if (data->ENABLE_CODE_PREFETCH){
+      *((unsigned long long*)(mydata->cache_flush_area))=(unsigned long long)(mydata->cache_flush_area); //pointer to itself
+      for (j=0;j<mydata->NUM_USES;j++) asm_work_mov((unsigned long long)(mydata->cache_flush_area),1,data);
+    }
+    tmp=asm_work_mov(mydata->aligned_addr,num_accesses/24,data);
+
+    // discard first iteration if more than 1 runs are performed
+    if (((run>0)||(runs==1))&&(tmp!=-1)&&(tmp>tmax)) tmax=tmp;
+  }
+  free(lines);
+  mydata->sweep_latency=tmax;
+}
+
+void start_sweep(volatile mydata_t *data, int t, unsigned long long memsize, int def_alignment, int num_accesses, int runs)
+{
+  data->threaddata[t].memsize=memsize;
+  data->threaddata[t].sweep_alignment=def_alignment;
+  data->threaddata[t].accesses=num_accesses;
+  data->threaddata[t].sweep_runs=runs;
+  data->threaddata[t].sweep_busy=1;
+  __asm__ __volatile__("mfence;"::: "memory");
+  data->thread_comm[t]=THREAD_SWEEP;
+  while (!data->ack);
+  data->ack=0;
+}
+
+unsigned long long finish_sweep(volatile mydata_t *data, int t)
+{
+  while (data->threaddata[t].sweep_busy);
+  data->thread_comm[t]=THREAD_WAIT;
+  while (!data->ack);
+  data->ack=0;
+  return data->threaddata[t].sweep_latency;
+}
+
+/** function that performs the measurement
+ *   - entry point for BenchIT framework (called by bi_entry())
+ */
+void _work(unsigned long long memsize, int def_alignment, int offset, int function, int num_accesses, int runs, volatile mydata_t* data, double **results)
+{
+  int i,j,k,t,max_threads;
+  unsigned long long tmax,tmp,tmp2,tmp3,mask;
+  double hops=1.0;
+  
+  unsigned long long usable_memory,num_pages,accesses_per_page,usable_page_size;
+	
+  unsigned long long tmp_addr,tmp_offset,max_accesses;	
+
+  /* aligned address */
+  unsigned long long aligned_addr;
+
+
+  struct timeval time;
+
+  /* noise rejection */
+  noise_snapshot_t noise_before,noise_after;
+  unsigned int rejected,retries,forced,late_readers;
+  
+  gettimeofday( &time, (struct timezone *) 0);
+
+ 
+  /* use rdtsc latency parameter for loop overhead compensation */
+  if ((data->settings)&LOOP_OVERHEAD_COMP) data->cpuinfo->rdtsc_latency=data->loop_overhead;
+  
+  /* first-touch latency does not use the buffers */
+  if (data->PAGE_FAULT_MODE){
+    work_page_faults(memsize,runs,data,results);
+    return;
+  }
+
+  /* neither does the wake-up latency */
+  if (wakeup_mode){
+    work_wakeup(memsize,data,results);
+    return;
+  }
+
+  /* instruction fetch latency does not use the buffers either */
+  if (data->CODE_LATENCY){
+    work_code_latency(memsize,num_accesses,runs,data,results);
+    return;
+  }
+
+  /* calculate aligned address*/
+  aligned_addr = (unsigned long long)(data->buffer)+offset;
+
+  /* lazy initialization (BENCHIT_KERNEL_LAZY_INIT): all threads grow their buffers to the current size in parallel,
+   * each thread touches its own buffer first, so the memory affinity is the same as with the initialization in bi_init() */
+  if (data->LAZY_INIT){
+    for (t=1;t<data->num_threads-data->NUM_SWEEP_CPUS;t++){
+      data->threaddata[t].memsize=memsize;
+      __asm__ __volatile__("mfence;"::: "memory");
+      data->thread_comm[t]=THREAD_INIT_BUFFER;
+      while (!data->ack);
+      data->ack=0;
+    }
+    init_buffer(data->buffer,data->threaddata[0].buffersize,(unsigned long long*)&(data->threaddata[0].initialized),offset+memsize,data->cpuinfo);
+    for (t=1;t<data->num_threads-data->NUM_SWEEP_CPUS;t++){
+      data->thread_comm[t]=THREAD_WAIT;
+      //wait for other thread finishing the initialization
+      while (!data->ack);
+      data->ack=0;
+    }
+  }
+  
+  /* placement of the data that is measured in this call (BENCHIT_KERNEL_VERIFY_PLACEMENT) */
+  if (data->settings&VERIFY_PLACEMENT){
+    placement_t placement;
+    char *buffer;
+    for (t=0;t<data->num_results;t++){
+      if (t) buffer=data->threaddata[t].buffer;
+      else buffer=data->buffer;
+      tmp=check_placement(buffer,offset+memsize,numa_node_of_cpu(data->threaddata[t].mem_bind),(data->hugepages==HUGEPAGES_ON),&placement);
+      data->threaddata[t].misplaced=(tmp>0);
+      if (tmp) {printf("  Warning: %llu of %llu pages not placed as requested for %llu Byte (CPU%u - CPU%u)\n",tmp,placement.pages,memsize,data->threaddata[0].cpu_id,data->threaddata[t].cpu_id);fflush(stdout);}
+    }
+  }
+
+  accesses=num_accesses;
+  alignment=def_alignment;
+
+  mask=(data->pagesize-1)^0xffffffffffffffffULL;
+  usable_memory=(memsize&mask);
+  usable_page_size=data->pagesize;
+
+  if ((data->settings&RESTORE_TLB)&&(data->hugepages==HUGEPAGES_OFF))
+  {
+    usable_memory=usable_memory/2;
+    usable_page_size=(data->pagesize)/2;
+    if (usable_memory>data->tlb_size*(data->pagesize/2)) usable_memory=data->tlb_size*(data->pagesize/2);
+    reset_tlb_check(data);
+  }
+
+  max_accesses=(usable_memory/alignment);
+  if (max_accesses<accesses) accesses=max_accesses;
+  num_pages=usable_memory/usable_page_size;
+  accesses=(accesses/24)*24;
+
+  data->page_address=(unsigned long long*)realloc(data->page_address,num_pages*sizeof(unsigned long long));
+  for (t=1;t<data->num_threads;t++) data->threaddata[t].page_address=(unsigned long long*)realloc(data->threaddata[t].page_address,num_pages*sizeof(unsigned long long));
+
+  if (accesses<=num_pages) {num_pages=accesses;usable_memory=num_pages*usable_page_size;/*alignment=usable_page_size;*/}
+
+
+  if ((accesses<=48) && (memsize<data->cpuinfo->Total_D_Cache_Size)) runs*=2;
+  if ((accesses<=120) && (memsize<data->cpuinfo->Total_D_Cache_Size)) runs*=2;
+  if (memsize>data->cpuinfo->Total_D_Cache_Size) runs/=3;
+  if (runs==0) runs=1;
+  /* time-series sampling: one data placement per CPU, followed by the samples */
+  if (data->sampling) runs=1;
 
   max_threads=data->num_results;
   for (t=0;t<max_threads;t++)
   {
+   /* local result already measured on a sweep CPU (BENCHIT_KERNEL_SWEEP_CPU_LIST) */
+   if ((!t)&&(data->skip_local)) continue;
+    /* CPU not selected by the current scenario (BENCHIT_KERNEL_SCENARIO_FILE) */
+    if ((measured_threads)&&(!measured_threads[t])) continue;
+   rejected=0;retries=0;forced=0;late_readers=0;
    #ifdef AVERAGE
     tmax=0;
     #ifdef USE_PAPI
@@ -826,6 +2058,10 @@ void _work(unsigned long long memsize, int def_alignment, int offset, int functi
     for (i=0;i<runs;i++)
     {
       iteration=i;
+
+      /* bracket the whole run (data placement, flushes, and measurement), as disturbances during the placement
+       * change the coherence state or cache content as well */
+      if (data->NOISE_REJECTION) take_noise_snapshot(data->threaddata[0].cpu_id,data->threaddata[t].cpu_id,&noise_before);
     /* USE MODE ADAPTION (for BENCHIT_KERNEL_*_USE_MODE={S|F|O})
      * enforcing data to be in one of the shared coherency states (SHARED/OWNED/FORWARD), is implemented by adapting the target state for
      * individual accesses (a specific core (BENCHIT_KERNEL_SHARE_CPU) is used to share cachelines with the currently selected CPU (thread_id))
@@ -848,7 +2084,25 @@ void _work(unsigned long long memsize, int def_alignment, int offset, int functi
       //as core0 is idle in case of accssesing other cores memory and will retain page tables in it's cache that are lost if core0 is active (if t==0)
       if ((t) && (data->FLUSH_PT) && (data->hugepages == HUGEPAGES_OFF)) use_memory((void*)(aligned_addr),data->cache_flush_area,memsize,MODE_EXCLUSIVE,FIFO,data->NUM_USES,*(data->cpuinfo),data,NULL);
 
-   if (!strcmp("GenuineIntel",data->cpuinfo->vendor))
+   /* SHARER SCALING (BENCHIT_KERNEL_SHARER_SCALING)
+    * result t: the buffer of thread 1 is shared by threads 1 to t (t=0: local measurement with exclusive copy)
+    *  - thread 1 accesses the buffer with use mode EXCLUSIVE, this invalidates all copies from previous runs
+    *  - threads 2 to t read the buffer, the last reader holds the forward copy
+    *  - S: first CPU in SHARED_CPU_LIST reads last and holds the forward copy, threads 1 to t keep shared copies
+    *  - F: thread t holds the forward copy
+    */
+   if (data->SHARER_SCALING)
+   {
+      if (!t) use_memory((void*)aligned_addr,data->cache_flush_area,memsize,MODE_EXCLUSIVE,FIFO,data->NUM_USES,*(data->cpuinfo),data,NULL);
+      else{
+        for (j=1;j<=t;j++){
+          if (j==1) use_memory_on_thread(data,j,data->threaddata[1].aligned_addr,memsize,MODE_EXCLUSIVE);
+          else use_memory_on_thread(data,j,data->threaddata[1].aligned_addr,memsize,MODE_FORWARD);
+        }
+        if (data->USE_MODE==MODE_SHARED) use_memory_on_thread(data,data->FRST_SHARE_CPU,data->threaddata[1].aligned_addr,memsize,MODE_SHARED);
+      }
+   }
+   else if (!strcmp("GenuineIntel",data->cpuinfo->vendor))
    {
       /* 
        * create copies in CPUs from SHARED_CPU_LIST first, forward copy in target CPU will be created in next step
@@ -942,7 +2196,7 @@ void _work(unsigned long long memsize, int def_alignment, int offset, int functi
         }
       }
    }
-   if (!strcmp("AuthenticAMD",data->cpuinfo->vendor))
+   else if (!strcmp("AuthenticAMD",data->cpuinfo->vendor))
    {
 
       /*
@@ -1096,8 +2350,8 @@ void _work(unsigned long long memsize, int def_alignment, int offset, int functi
    }
 
       //flush cachelevels as specified in PARAMETERS
-      //tell threads on shared CPUs to flush caches  
-      for (j=data->FRST_SHARE_CPU;j<data->FRST_SHARE_CPU+data->NUM_SHARED_CPUS;j++){
+      //tell threads on shared CPUs to flush caches (concurrent readers do not hold copies)
+      for (j=data->FRST_SHARE_CPU;j<data->FRST_SHARE_CPU+data->NUM_SHARED_CPUS-data->CONCURRENT_READERS;j++){
          if (data->flush_share_cpu) data->thread_comm[j]=THREAD_FLUSH_ALL;
          else data->thread_comm[j]=THREAD_FLUSH;
          while (!data->ack);
@@ -1107,6 +2361,15 @@ void _work(unsigned long long memsize, int def_alignment, int offset, int functi
          while (!data->ack); //printf("wait for ack 6\n");
          data->ack=0;       
       }     
+      //tell other sharers to flush caches, the last sharer is the target CPU
+      if (data->SHARER_SCALING) for (j=1;j<t;j++){
+         data->thread_comm[j]=THREAD_FLUSH;
+         while (!data->ack);
+         data->ack=0;
+         data->thread_comm[j]=THREAD_WAIT;    
+         while (!data->ack);
+         data->ack=0;
+      }
       if (t){
          //tell thread on target CPU to flush caches
          data->thread_comm[t]=THREAD_FLUSH;
@@ -1155,12 +2418,36 @@ void _work(unsigned long long memsize, int def_alignment, int offset, int functi
                }
                //measurement
 	       //if(t) tmp=asm_work_mov(data->threaddata[t].aligned_addr,accesses/24,data);
-               if (!t) tmp=asm_work_mov(aligned_addr,accesses/24,data);
-               else tmp=asm_work_mov(data->threaddata[t].aligned_addr,accesses/24,data);
+               if (!t) tmp_addr=aligned_addr;
+               else if (data->SHARER_SCALING) tmp_addr=data->threaddata[1].aligned_addr;
+               else tmp_addr=data->threaddata[t].aligned_addr;
+               if ((t)&&(data->SHARER_SCALING)&&(data->CONCURRENT_READERS)) start_concurrent_readers(data,tmp_addr);
+               if (data->sampling) tmp=take_samples(data,tmp_addr,data->threaddata[t].cpu_id);
+               else if (structure_mode!=STRUCTURE_OFF){
+                 /* cycles of all accesses, converted to the latency per node or lookup below */
+                 tmp=asm_work_mov_cycles(tmp_addr,accesses/24,data);
+                 hops=buffer_owner(data,tmp_addr)->structure_hops;
+               }
+               else tmp=asm_work_mov(tmp_addr,accesses/24,data);
+               if ((t)&&(data->SHARER_SCALING)&&(data->CONCURRENT_READERS)) late_readers+=stop_concurrent_readers(data);
                break;
        default: break;
      }
 
+      /* reject and repeat disturbed runs */
+      if (data->NOISE_REJECTION){
+        take_noise_snapshot(data->threaddata[0].cpu_id,data->threaddata[t].cpu_id,&noise_after);
+        if (noise_detected(&noise_before,&noise_after,data->NOISE_REJECTION)){
+          if (retries<data->NOISE_RETRIES){
+            retries++;rejected++;
+            i--;
+            continue;
+          }
+          forced++;
+        }
+        retries=0;
+      }
+
       // discard first iteration if more than 1 runs are performed
       if (((i>0)||(runs==1))&&(tmp!=-1))
       {
@@ -1199,11 +2486,878 @@ void _work(unsigned long long memsize, int def_alignment, int offset, int functi
    }
    else tmax=0;
   
-   if (tmax) (*results)[t]=(double)tmax;
+   if ((tmax)&&(structure_mode!=STRUCTURE_OFF)) (*results)[t]=(double)tmax*hops/(double)((accesses/24)*24);
+   else if (tmax) (*results)[t]=(double)tmax;
    else (*results)[t]=INVALID_MEASUREMENT;
+   if ((data->settings&REJECT_MISPLACED)&&(data->threaddata[t].misplaced)) (*results)[t]=INVALID_MEASUREMENT;
+
+   if (data->NOISE_REJECTION){
+     data->noise_results[t]=(double)rejected;
+     if (forced) {printf("  Warning: %u disturbed run(s) accepted for %llu Byte (CPU%u - CPU%u) after %u retries\n",forced,memsize,data->threaddata[0].cpu_id,data->threaddata[t].cpu_id,(unsigned int)data->NOISE_RETRIES);fflush(stdout);}
+   }
+   /* readers that missed the measurement, the result reflects fewer concurrent readers than the legend says */
+   if (late_readers) {printf("  Warning: %u concurrent reader(s) missed the measurement for %llu Byte (CPU%u - CPU%u), %.1f of %u readers per run\n",late_readers,memsize,data->threaddata[0].cpu_id,data->threaddata[t].cpu_id,(double)data->CONCURRENT_READERS-(double)late_readers/(double)runs,(unsigned int)data->CONCURRENT_READERS);fflush(stdout);}
+  }
+}
+
+
+char *alloc_shared_buffer(unsigned long long size)
+{
+  int fd;
+  char *buffer;
+
+  fd=memfd_create("benchit_buffer",0);
+  if (fd==-1) return NULL;
+  if (ftruncate(fd,size)) {close(fd);return NULL;}
+  buffer=(char*) mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+  close(fd);
+  if (buffer==MAP_FAILED) return NULL;
+  return buffer;
+}
+
+/* number of pages that are passed to move_pages() at once */
+#define PLACEMENT_BATCH 4096
+
+unsigned long long check_placement(char *buffer, unsigned long long size, int node, int huge, placement_t *placement)
+{
+  unsigned long long i,j,n,start,page_size,num_pages,pfn,flags,misplaced=0;
+  unsigned long long entries[PLACEMENT_BATCH];
+  void *pages[PLACEMENT_BATCH];
+  int status[PLACEMENT_BATCH];
+  int fd_pagemap,fd_kpageflags,got_entries;
+
+  memset(placement,0,sizeof(placement_t));
+  if ((buffer==NULL)||(size==0)) return 0;
+  page_size=sysconf(_SC_PAGESIZE);
+  start=((unsigned long long)buffer)&~(page_size-1);
+  num_pages=((unsigned long long)buffer+size-start+page_size-1)/page_size;
+
+  /* page sizes are only available if the PFNs can be read */
+  fd_pagemap=open("/proc/self/pagemap",O_RDONLY);
+  fd_kpageflags=open("/proc/kpageflags",O_RDONLY);
+
+  for (i=0;i<num_pages;i+=n){
+    n=num_pages-i;
+    if (n>PLACEMENT_BATCH) n=PLACEMENT_BATCH;
+    for (j=0;j<n;j++) pages[j]=(void*)(start+(i+j)*page_size);
+    /* nodes=NULL: only query the location */
+    if (move_pages(0,n,pages,NULL,status,0)) for (j=0;j<n;j++) status[j]=-ENOSYS;
+    got_entries=0;
+    if (fd_pagemap!=-1) got_entries=(pread(fd_pagemap,entries,n*sizeof(unsigned long long),(start/page_size+i)*sizeof(unsigned long long))==(ssize_t)(n*sizeof(unsigned long long)));
+
+    for (j=0;j<n;j++){
+      placement->pages++;
+      /* bit 63: present */
+      if ((status[j]==-ENOENT)||((got_entries)&&(!(entries[j]>>63)))) {placement->not_present++;continue;}
+      if ((status[j]>=0)&&(status[j]<PLACEMENT_MAX_NODES)){
+        placement->nodes[status[j]]++;
+        if (status[j]!=node) placement->wrong_node++;
+      }
+      else placement->unknown_node++;
+
+      /* bits 0-54: PFN, 0 without CAP_SYS_ADMIN; kpageflags bit 17: HUGE (hugetlbfs), bit 22: THP */
+      pfn=0;
+      if (got_entries) pfn=entries[j]&((1ULL<<55)-1);
+      if ((pfn)&&(fd_kpageflags!=-1)&&(pread(fd_kpageflags,&flags,sizeof(flags),pfn*sizeof(unsigned long long))==sizeof(flags))){
+        if (flags&((1ULL<<17)|(1ULL<<22))) placement->huge_pages++;
+        else {placement->small_pages++;if ((huge)&&(status[j]==node)) misplaced++;}
+      }
+      else placement->unknown_size++;
+      if ((status[j]>=0)&&(status[j]!=node)) misplaced++;
+    }
+  }
+  if (fd_pagemap!=-1) close(fd_pagemap);
+  if (fd_kpageflags!=-1) close(fd_kpageflags);
+
+  return misplaced;
+}
+
+/* number of measurements per access pair, the median is used */
+#define DRAM_SOLVE_ROUNDS 15
+/* maximal number of banks (groups of conflicting lines) that are searched */
+#define DRAM_SOLVE_GROUPS 64
+
+/** median latency of DRAM_SOLVE_ROUNDS accesses to the lines addr1 and addr2 */
+static unsigned long long pair_latency(unsigned long long addr1, unsigned long long addr2)
+{
+  unsigned long long samples[DRAM_SOLVE_ROUNDS];
+  int i;
+
+  for (i=0;i<DRAM_SOLVE_ROUNDS;i++) samples[i]=asm_pair_latency(addr1,addr2);
+  qsort(samples,DRAM_SOLVE_ROUNDS,sizeof(unsigned long long),compare_ull);
+  return samples[DRAM_SOLVE_ROUNDS/2];
+}
+
+int solve_dram_functions(unsigned long long size, int num_samples, unsigned long long threshold, unsigned long long *functions, int max_functions)
+{
+  unsigned long long *entries,*virt,*phys,*latency,*sorted,max_phys=0,gap;
+  char *buffer;
+  int *groups,i,j,k,num_groups=0,max_bit,num_functions=0;
+
+  buffer=(char*)mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if (buffer==(char*)MAP_FAILED){
+    fprintf( stderr, "Error: Allocation of the DRAM solver buffer failed\n" ); fflush( stderr );
+    perror("mmap");
+    exit( 127 );
+  }
+  /* transparent huge pages reduce TLB misses during the measurement, the physical addresses are read anyway */
+  madvise(buffer,size,MADV_HUGEPAGE);
+  memset(buffer,0,size);
+  entries=read_pagemap((unsigned long long)buffer,size/4096);
+  if (entries==NULL) {munmap(buffer,size);return -1;}
+
+  virt=(unsigned long long*)malloc(num_samples*sizeof(unsigned long long));
+  phys=(unsigned long long*)malloc(num_samples*sizeof(unsigned long long));
+  latency=(unsigned long long*)malloc(num_samples*sizeof(unsigned long long));
+  sorted=(unsigned long long*)malloc(num_samples*sizeof(unsigned long long));
+  groups=(int*)malloc(num_samples*sizeof(int));
+  if ((virt==NULL)||(phys==NULL)||(latency==NULL)||(sorted==NULL)||(groups==NULL)){
+    fprintf( stderr, "Error: Allocation of the DRAM solver data failed\n" ); fflush( stderr );
+    exit( 127 );
+  }
+
+  /* random lines, sample 0 is the first reference line, the lines are cached after the initialization and
+   * flushed by asm_pair_latency(), the median of the measurements ignores the first access */
+  _random_init(random_start(size,6),size/STRIDE);
+  for (i=0;i<num_samples;i++){
+    virt[i]=(unsigned long long)buffer+(unsigned long long)_random()*STRIDE;
+    phys[i]=pagemap_phys(entries,(unsigned long long)buffer,virt[i]);
+    if (phys[i]>max_phys) max_phys=phys[i];
+    groups[i]=-1;
+  }
+  free(entries);
+
+  /* threshold: largest gap between the sorted latencies above the median (row conflicts are a small minority) */
+  if (threshold==0){
+    for (i=1;i<num_samples;i++) latency[i]=pair_latency(virt[0],virt[i]);
+    memcpy(sorted,latency+1,(num_samples-1)*sizeof(unsigned long long));
+    qsort(sorted,num_samples-1,sizeof(unsigned long long),compare_ull);
+    gap=0;
+    for (i=(num_samples-1)/2;i<num_samples-2;i++) if (sorted[i+1]-sorted[i]>gap){
+      gap=sorted[i+1]-sorted[i];
+      threshold=(sorted[i+1]+sorted[i])/2;
+    }
+    printf("  DRAM solver: median pair latency %llu cycles, row conflict threshold %llu cycles\n",sorted[(num_samples-1)/2],threshold);
+  }
+
+  /* groups of lines that conflict with a reference line, i.e. are located in the same bank */
+  for (i=0;(i<num_samples)&&(num_groups<DRAM_SOLVE_GROUPS);i++){
+    if (groups[i]!=-1) continue;
+    k=0;
+    for (j=i+1;j<num_samples;j++) if ((groups[j]==-1)&&(pair_latency(virt[i],virt[j])>threshold)) {groups[j]=num_groups;k++;}
+    /* single conflicts are likely to be noise */
+    if (k<2){
+      for (j=i+1;j<num_samples;j++) if (groups[j]==num_groups) groups[j]=-1;
+      groups[i]=-2;
+    }
+    else groups[i]=num_groups++;
+  }
+  printf("  DRAM solver: %i banks with row conflicts found in %i lines\n",num_groups,num_samples);
+
+  for (max_bit=0;(max_bit<63)&&((1ULL<<(max_bit+1))<=max_phys);max_bit++);
+  if (num_groups>1) num_functions=find_xor_functions(phys,groups,num_samples,6,max_bit,4,functions,max_functions);
+
+  free(virt);free(phys);free(latency);free(sorted);free(groups);
+  munmap(buffer,size);
+  return num_functions;
+}
+
+/* repetitions of each fence measurement, the minimum is reported */
+#define FENCE_REPEATS 5
+
+int fence_supported(int type)
+{
+  unsigned int a,b,c,d;
+
+  if (type!=FENCE_SERIALIZE) return 1;
+  if (!__get_cpuid_count(7,0,&a,&b,&c,&d)) return 0;
+  return (d>>14)&1;
+}
+
+void measure_fences(unsigned long long buffer_size, unsigned long long iterations, double *cycles)
+{
+  unsigned long long tmin,tmp;
+  char *buffer;
+  int type,context,i;
+
+  /* allocated and touched on the current CPU, so the misses go to local memory */
+  buffer=(char*)mmap(NULL,buffer_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if (buffer==(char*)MAP_FAILED){
+    fprintf( stderr, "Error: Allocation of the fence measurement buffer failed\n" ); fflush( stderr );
+    perror("mmap");
+    exit( 127 );
+  }
+  memset(buffer,0,buffer_size);
+
+  for (type=0;type<FENCE_TYPES;type++){
+    for (context=0;context<FENCE_CONTEXTS;context++){
+      if (!fence_supported(type)) {cycles[type*FENCE_CONTEXTS+context]=-1;continue;}
+      /* the first run warms up the loop and the TLB */
+      asm_fence_loop(type,context,iterations/10+1,buffer,buffer_size-1);
+      tmin=ULLONG_MAX;
+      for (i=0;i<FENCE_REPEATS;i++){
+        tmp=asm_fence_loop(type,context,iterations,buffer,buffer_size-1);
+        if (tmp<tmin) tmin=tmp;
+      }
+      cycles[type*FENCE_CONTEXTS+context]=(double)tmin/(double)iterations;
+    }
+  }
+
+  munmap(buffer,buffer_size);
+}
+
+/** writes a pointer chain through all lines of buffer in random order, the first line is implicitely selected
+ *  @return offsets of the lines in the order of the chain, has to be freed by the caller
+ */
+static unsigned long long *random_line_chain(char *buffer, unsigned long long lines)
+{
+  unsigned long long *order,i;
+
+  order=(unsigned long long*)malloc(lines*sizeof(unsigned long long));
+  if (order==NULL){
+    fprintf( stderr, "Error: Allocation of the pointer chain failed\n" ); fflush( stderr );
+    exit( 127 );
+  }
+  order[0]=0;
+  _random_init(1,lines-1);
+  for (i=1;i<lines;i++) order[i]=((unsigned long long)_random()+1)*64;
+  for (i=0;i<lines;i++) *((char**)(buffer+order[i]))=buffer+order[(i+1)%lines];
+  return order;
+}
+
+/* repetitions of each prefetch measurement, the minimum is reported */
+#define PREFETCH_REPEATS 3
+
+/* keeps the loads of the prefetch measurement */
+static volatile unsigned long long prefetch_sink;
+
+int prefetch_supported(int type)
+{
+  unsigned int a,b,c,d;
+
+  if (type!=PREFETCH_W) return 1;
+  if (!__get_cpuid(0x80000001,&a,&b,&c,&d)) return 0;
+  return (c>>8)&1;
+}
+
+/* gathers through the index array, the line distance accesses ahead is prefetched */
+#define PREFETCH_INDEX_LOOP(insn) \
+  for (n=0;n<accesses;n++){ \
+    __asm__ __volatile__(insn " (%0);" :: "r" (buffer+index[i+distance])); \
+    sum+=*((unsigned long long*)(buffer+index[i])); \
+    if (++i==lines) i=0; \
+  }
+/* pointer chasing, the jump pointer in the second word is prefetched */
+#define PREFETCH_CHAIN_LOOP(insn) \
+  for (n=0;n<accesses;n++){ \
+    __asm__ __volatile__(insn " (%0);" :: "r" (((char**)ptr)[1])); \
+    ptr=*((char**)ptr); \
+  }
+
+/** accesses to the pattern with prefetch instruction type, starting at the first line, a partial pass if the pattern
+ *  has more lines
+ *  @return cycles
+ */
+static unsigned long long prefetch_loop(int pattern, int type, char *buffer, unsigned long long *index, unsigned long long lines, unsigned long long accesses, int distance)
+{
+  unsigned long long start,end,sum=0,n,i=0;
+  char *ptr=buffer;
+
+  start=read_tsc();
+  if (pattern==PREFETCH_INDEX){
+    switch (type){
+      case PREFETCH_T0: PREFETCH_INDEX_LOOP("prefetcht0") break;
+      case PREFETCH_T1: PREFETCH_INDEX_LOOP("prefetcht1") break;
+      case PREFETCH_T2: PREFETCH_INDEX_LOOP("prefetcht2") break;
+      case PREFETCH_NTA: PREFETCH_INDEX_LOOP("prefetchnta") break;
+      case PREFETCH_W: PREFETCH_INDEX_LOOP("prefetchw") break;
+      default:
+        for (n=0;n<accesses;n++){
+          sum+=*((unsigned long long*)(buffer+index[i]));
+          if (++i==lines) i=0;
+        }
+    }
+  }
+  else{
+    switch (type){
+      case PREFETCH_T0: PREFETCH_CHAIN_LOOP("prefetcht0") break;
+      case PREFETCH_T1: PREFETCH_CHAIN_LOOP("prefetcht1") break;
+      case PREFETCH_T2: PREFETCH_CHAIN_LOOP("prefetcht2") break;
+      case PREFETCH_NTA: PREFETCH_CHAIN_LOOP("prefetchnta") break;
+      case PREFETCH_W: PREFETCH_CHAIN_LOOP("prefetchw") break;
+      default:
+        for (n=0;n<accesses;n++) ptr=*((char**)ptr);
+    }
+    sum=(unsigned long long)ptr;
+  }
+  end=read_tsc();
+  prefetch_sink=sum;
+  return end-start;
+}
+
+void measure_prefetch(int pattern, unsigned long long size, unsigned long long accesses, int *distances, int num_distances, double *cycles)
+{
+  unsigned long long *order,*index,lines,warmup,i,tmin,tmp;
+  char *buffer;
+  int type,d,j,max_distance=0;
+
+  /* allocated and touched on the current CPU, so the misses go to local memory */
+  buffer=(char*)mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if (buffer==(char*)MAP_FAILED){
+    fprintf( stderr, "Error: Allocation of the prefetch measurement buffer failed\n" ); fflush( stderr );
+    perror("mmap");
+    exit( 127 );
+  }
+  memset(buffer,0,size);
+
+  /* random order of all cachelines, the next pointers of the chain do not change with the distance */
+  lines=size/64;
+  for (d=0;d<num_distances;d++) if (distances[d]>max_distance) max_distance=distances[d];
+  order=random_line_chain(buffer,lines);
+  index=(unsigned long long*)malloc((lines+max_distance)*sizeof(unsigned long long));
+  if (index==NULL){
+    fprintf( stderr, "Error: Allocation of the prefetch index array failed\n" ); fflush( stderr );
+    exit( 127 );
+  }
+  /* the index array continues with the first lines, so the prefetches ahead of the last accesses stay in the pattern */
+  for (i=0;i<lines+max_distance;i++) index[i]=order[i%lines];
+  /* the measurement is bound by accesses, data sets with more lines are only partially walked */
+  warmup=accesses;
+  if (warmup>lines) warmup=lines;
+
+  for (type=0;type<PREFETCH_TYPES;type++){
+    for (d=0;d<num_distances;d++){
+      if (!prefetch_supported(type)) {cycles[type*num_distances+d]=-1;continue;}
+      if ((type==PREFETCH_NONE)&&(d)) {cycles[type*num_distances+d]=cycles[type*num_distances];continue;}
+      if (pattern==PREFETCH_CHAIN) for (i=0;i<lines;i++) *((char**)(buffer+order[i])+1)=buffer+order[(i+distances[d])%lines];
+      /* the first run warms up the loop and the TLB */
+      prefetch_loop(pattern,type,buffer,index,lines,warmup,distances[d]);
+      tmin=ULLONG_MAX;
+      for (j=0;j<PREFETCH_REPEATS;j++){
+        tmp=prefetch_loop(pattern,type,buffer,index,lines,accesses,distances[d]);
+        if (tmp<tmin) tmin=tmp;
+      }
+      cycles[type*num_distances+d]=(double)tmin/(double)accesses;
+    }
+  }
+
+  free(order);free(index);
+  munmap(buffer,size);
+}
+
+/* repetitions of each store-to-load forwarding measurement, the minimum is reported */
+#define FORWARD_REPEATS 5
+
+/* store size, store offset, load size and load offset of the FORWARD_* cases */
+static const int forward_cases[FORWARD_CASES][4]={
+  {8,0,8,0},{4,0,4,0},{1,0,1,0},
+  {8,0,4,0},{8,0,4,4},{8,0,1,7},
+  {4,0,8,0},{8,0,8,4},
+  {8,1,8,1},{8,5,8,5},
+  {8,60,8,60},{4,62,4,62},
+  {8,4092,8,4092}};
+
+/* 8 store/load pairs per iteration, the loaded value (0) is stored by the next pair
+ * the load address is either the base register (can be bypassed by memory renaming) or base + index register (0) */
+#define FORWARD_PAIR(st,ld) st ld
+#define FORWARD_LOOP(st,ld) \
+  __asm__ __volatile__( \
+    "xor %%eax,%%eax;" \
+    "1:" \
+    FORWARD_PAIR(st,ld) FORWARD_PAIR(st,ld) FORWARD_PAIR(st,ld) FORWARD_PAIR(st,ld) \
+    FORWARD_PAIR(st,ld) FORWARD_PAIR(st,ld) FORWARD_PAIR(st,ld) FORWARD_PAIR(st,ld) \
+    "sub $1,%0;" \
+    "jnz 1b;" \
+    : "+r" (n) : "r" (store), "r" (load), "r" (zero) : "%rax","memory");
+#define FORWARD_SIZES(addr) \
+  switch (store_size*16+load_size){ \
+    case 8*16+8: FORWARD_LOOP("mov %%rax,(%1);","mov " addr ",%%rax;") break; \
+    case 4*16+4: FORWARD_LOOP("mov %%eax,(%1);","mov " addr ",%%eax;") break; \
+    case 1*16+1: FORWARD_LOOP("mov %%al,(%1);","movzbl " addr ",%%eax;") break; \
+    case 8*16+4: FORWARD_LOOP("mov %%rax,(%1);","mov " addr ",%%eax;") break; \
+    case 8*16+1: FORWARD_LOOP("mov %%rax,(%1);","movzbl " addr ",%%eax;") break; \
+    case 4*16+8: FORWARD_LOOP("mov %%eax,(%1);","mov " addr ",%%rax;") break; \
+  }
+
+/** runs iterations*8 dependent store/load pairs
+ *  @return cycles
+ */
+static unsigned long long forward_loop(int store_size, int load_size, char *store, char *load, int indexed, unsigned long long iterations)
+{
+  unsigned long long start,end,n=iterations,zero=0;
+
+  start=read_tsc();
+  if (indexed) {FORWARD_SIZES("(%2,%3)")}
+  else {FORWARD_SIZES("(%2)")}
+  end=read_tsc();
+  return end-start;
+}
+
+void measure_forwarding(unsigned long long iterations, double *renamed_cycles, double *forwarded_cycles)
+{
+  unsigned long long tmin,tmp;
+  char *buffer;
+  int c,i,indexed;
+
+  buffer=(char*)mmap(NULL,2*4096,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if (buffer==(char*)MAP_FAILED){
+    fprintf( stderr, "Error: Allocation of the store forwarding buffer failed\n" ); fflush( stderr );
+    perror("mmap");
+    exit( 127 );
+  }
+  memset(buffer,0,2*4096);
+
+  for (c=0;c<FORWARD_CASES;c++){
+    for (indexed=0;indexed<2;indexed++){
+      /* the first run warms up the loop */
+      forward_loop(forward_cases[c][0],forward_cases[c][2],buffer+forward_cases[c][1],buffer+forward_cases[c][3],indexed,iterations/10+1);
+      tmin=ULLONG_MAX;
+      for (i=0;i<FORWARD_REPEATS;i++){
+        tmp=forward_loop(forward_cases[c][0],forward_cases[c][2],buffer+forward_cases[c][1],buffer+forward_cases[c][3],indexed,iterations);
+        if (tmp<tmin) tmin=tmp;
+      }
+      if (indexed) forwarded_cycles[c]=(double)tmin/(double)(iterations*8);
+      else renamed_cycles[c]=(double)tmin/(double)(iterations*8);
+    }
+  }
+
+  munmap(buffer,2*4096);
+}
+
+/* 8 store/load pairs per iteration, the loaded value (0) is added to the store address */
+#define ALIASING_PAIR "mov %%rax,(%1);mov (%1,%2),%%rax;add %%rax,%1;"
+
+/** runs iterations*8 store/load pairs with the load at store+distance
+ *  @return cycles
+ */
+static unsigned long long aliasing_loop(char *store, long long distance, unsigned long long iterations)
+{
+  unsigned long long start,end,n=iterations;
+
+  start=read_tsc();
+  __asm__ __volatile__(
+    "xor %%eax,%%eax;"
+    "1:"
+    ALIASING_PAIR ALIASING_PAIR ALIASING_PAIR ALIASING_PAIR ALIASING_PAIR ALIASING_PAIR ALIASING_PAIR ALIASING_PAIR
+    "sub $1,%0;"
+    "jnz 1b;"
+    : "+r" (n), "+r" (store) : "r" (distance) : "%rax","memory");
+  end=read_tsc();
+  return end-start;
+}
+
+void measure_aliasing(unsigned long long iterations, int *distances, int num_distances, double *cycles)
+{
+  unsigned long long tmin,tmp,size;
+  char *buffer;
+  int d,i,max_distance=0;
+
+  for (d=0;d<num_distances;d++) if (distances[d]>max_distance) max_distance=distances[d];
+  size=((unsigned long long)max_distance+2*4096+4095)&~4095ULL;
+  buffer=(char*)mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if (buffer==(char*)MAP_FAILED){
+    fprintf( stderr, "Error: Allocation of the 4K aliasing buffer failed\n" ); fflush( stderr );
+    perror("mmap");
+    exit( 127 );
+  }
+  memset(buffer,0,size);
+
+  for (d=0;d<num_distances;d++){
+    /* the first run warms up the loop */
+    aliasing_loop(buffer,distances[d],iterations/10+1);
+    tmin=ULLONG_MAX;
+    for (i=0;i<FORWARD_REPEATS;i++){
+      tmp=aliasing_loop(buffer,distances[d],iterations);
+      if (tmp<tmin) tmin=tmp;
+    }
+    cycles[d]=(double)tmin/(double)(iterations*8);
+  }
+
+  munmap(buffer,size);
+}
+
+/* repetitions of each interleaved lookup measurement, the minimum is reported */
+#define INTERLEAVED_REPEATS 3
+
+/* keeps the loads of the interleaved lookup measurement */
+static volatile unsigned long long interleaved_sink;
+
+/** rounds over groups interleaved lookups, each round performs one access per lookup
+ *  finished lookups are replaced by the next one, which starts at a line selected by a multiplicative hash of its number
+ *  @return cycles
+ */
+static unsigned long long interleaved_loop(char *buffer, unsigned long long lines, int groups, unsigned long long rounds)
+{
+  char *node[INTERLEAVED_MAX_GROUPS];
+  int remaining[INTERLEAVED_MAX_GROUPS],g;
+  unsigned long long start,end,r,key=0,sum=0;
+
+  for (g=0;g<groups;g++){
+    key++;
+    node[g]=buffer+((((key*0x9e3779b97f4a7c15ULL)>>32)*lines)>>32)*64;
+    remaining[g]=INTERLEAVED_LOOKUP_LENGTH;
+  }
+  start=read_tsc();
+  for (r=0;r<rounds;r++){
+    for (g=0;g<groups;g++){
+      /* the line has been prefetched when the lookup was suspended */
+      if (--remaining[g]) node[g]=*((char**)node[g]);
+      else{
+        sum+=*((unsigned long long*)node[g]);
+        key++;
+        node[g]=buffer+((((key*0x9e3779b97f4a7c15ULL)>>32)*lines)>>32)*64;
+        remaining[g]=INTERLEAVED_LOOKUP_LENGTH;
+      }
+      __asm__ __volatile__("prefetcht0 (%0);" :: "r" (node[g]));
+    }
+  }
+  end=read_tsc();
+  /* the sink is only written after the measurement, a volatile update per lookup would add a dependency between them */
+  for (g=0;g<groups;g++) sum+=(unsigned long long)node[g];
+  interleaved_sink=sum;
+  return end-start;
+}
+
+void measure_interleaved(unsigned long long size, unsigned long long accesses, int *groups, int num_groups, double *cycles)
+{
+  unsigned long long lines,rounds,tmin,tmp;
+  char *buffer;
+  int g,j;
+
+  /* allocated and touched on the current CPU, so the misses go to local memory */
+  buffer=(char*)mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if (buffer==(char*)MAP_FAILED){
+    fprintf( stderr, "Error: Allocation of the interleaved lookup buffer failed\n" ); fflush( stderr );
+    perror("mmap");
+    exit( 127 );
+  }
+  memset(buffer,0,size);
+
+  /* random pointer chain through all cachelines */
+  lines=size/64;
+  free(random_line_chain(buffer,lines));
+
+  for (g=0;g<num_groups;g++){
+    rounds=accesses/groups[g]+1;
+    /* the first run warms up the loop and the TLB */
+    interleaved_loop(buffer,lines,groups[g],rounds/10+1);
+    tmin=ULLONG_MAX;
+    for (j=0;j<INTERLEAVED_REPEATS;j++){
+      tmp=interleaved_loop(buffer,lines,groups[g],rounds);
+      if (tmp<tmin) tmin=tmp;
+    }
+    cycles[g]=(double)tmin/(double)(rounds*groups[g]);
+  }
+
+  munmap(buffer,size);
+}
+
+/* passes over the victims per kind, the latencies of all passes are classified */
+#define VICTIM_REPEATS 3
+
+/* keeps the loads of the victim measurement */
+static volatile unsigned long long victim_sink;
+
+/** median of the n latencies in samples (sorted in place), 0 if n is 0 */
+static double median_latency(unsigned long long *samples, unsigned long long n)
+{
+  if (n==0) return 0;
+  qsort(samples,n,sizeof(unsigned long long),compare_ull);
+  return (double)samples[n/2];
+}
+
+/** latency of the victim at addr, the last line of the page is read before so that the TLB misses are not included
+ *  (one victim per page, the last two lines are not used)
+ */
+static unsigned long long victim_latency(unsigned long long addr)
+{
+  asm_line_latency((addr&~4095ULL)+4032);
+  return asm_line_latency(addr);
+}
+
+/** evicts the victims from L1 and L2
+ *  - conflict sweep: the lines of each L2 set that contains a victim are read from the sweep area 2*ways times,
+ *    sets are derived from the offset within the huge pages
+ *  - full sweep: 2 times the L2 size is read in scattered order, a sequential sweep is detected as a stream and does not
+ *    evict the victims
+ */
+static void victim_sweep(char *buffer, char *sweep, unsigned long long *victims, unsigned long long lines, unsigned long long way_size, unsigned long long ways, int conflict)
+{
+  unsigned long long sum=0,i,k;
+
+  if (conflict){
+    for (k=0;k<2*ways;k++) for (i=0;i<lines;i++) sum+=*((volatile unsigned long long*)(sweep+k*way_size+(victims[i]-(unsigned long long)buffer)%way_size));
+  }
+  else for (i=0;i<2*ways*way_size/64;i++) sum+=*((volatile unsigned long long*)(sweep+((i*1000003)%(2*ways*way_size/64))*64));
+  victim_sink=sum;
+}
+
+int measure_victims(unsigned long long l2_size, unsigned long long l2_ways, unsigned long long lines, unsigned long long *thresholds, victim_result_t *results)
+{
+  unsigned long long *victims,*samples,*sorted,victim_size,sweep_size,way_size,base,cached,dram,n[VICTIM_SOURCES],i,j,c,src;
+  char *buffer;
+  int kind,pass,conflict=1;
+
+  /* one victim per page, the prefetchers do not fetch other victims when the page is accessed
+   * the conflict sweep needs an L2 way that divides the huge page size */
+  if ((l2_ways==0)||(l2_size%l2_ways)) {l2_ways=1;conflict=0;}
+  way_size=l2_size/l2_ways;
+  if ((way_size%64)||(HUGEPAGE_SIZE%way_size)) conflict=0;
+  victim_size=((lines*4096+HUGEPAGE_SIZE-1)/HUGEPAGE_SIZE)*HUGEPAGE_SIZE;
+  sweep_size=((2*l2_size+HUGEPAGE_SIZE-1)/HUGEPAGE_SIZE)*HUGEPAGE_SIZE;
+  buffer=(char*)MAP_FAILED;
+  if (conflict) buffer=(char*)mmap(NULL,victim_size+sweep_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+  if (buffer==(char*)MAP_FAILED){
+    conflict=0;
+    buffer=(char*)mmap(NULL,victim_size+sweep_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  }
+  if (buffer==(char*)MAP_FAILED){
+    fprintf( stderr, "Error: Allocation of the victim measurement buffer failed\n" ); fflush( stderr );
+    perror("mmap");
+    exit( 127 );
+  }
+  memset(buffer,0,victim_size+sweep_size);
+
+  victims=(unsigned long long*)malloc(lines*sizeof(unsigned long long));
+  samples=(unsigned long long*)malloc(VICTIM_REPEATS*lines*sizeof(unsigned long long));
+  sorted=(unsigned long long*)malloc(VICTIM_REPEATS*lines*sizeof(unsigned long long));
+  if ((victims==NULL)||(samples==NULL)||(sorted==NULL)){
+    fprintf( stderr, "Error: Allocation of the victim measurement failed\n" ); fflush( stderr );
+    exit( 127 );
+  }
+  _random_init(1,lines);
+  for (i=0;i<lines;i++){
+    j=_random();
+    victims[i]=(unsigned long long)buffer+j*4096+(j%62)*64;
+  }
+
+  /* references: L1 hit, flushed lines, lines in L2 */
+  base=ULLONG_MAX;
+  for (i=0;i<64;i++) {j=asm_line_latency(victims[0]);if (j<base) base=j;}
+  /* the sweep also gives the write-backs of the flushed lines time to complete */
+  for (i=0;i<lines;i++) __asm__ __volatile__("clflush (%0);" :: "r" (victims[i]) : "memory");
+  victim_sweep(buffer,buffer+victim_size,victims,lines,way_size,l2_ways,conflict);
+  for (i=0;i<lines;i++) samples[i]=victim_latency(victims[i]);
+  dram=(unsigned long long)median_latency(samples,lines);
+  /* the lowest decile, lines that were evicted again by the TLB warm-up do not count */
+  for (i=0;i<lines;i++) samples[i]=victim_latency(victims[i]);
+  median_latency(samples,lines);
+  cached=samples[lines/10];
+  /* twice the latency of L2 above an L1 hit (at most a quarter of the way to memory), half way between an L1 hit and memory */
+  thresholds[0]=2*cached-base;
+  if (thresholds[0]>(3*base+dram)/4) thresholds[0]=(3*base+dram)/4;
+  if (!thresholds[1]) thresholds[1]=(base+dram)/2;
+  if (thresholds[1]<thresholds[0]) thresholds[1]=thresholds[0];
+
+  for (kind=0;kind<VICTIM_KINDS;kind++){
+    for (pass=0;pass<VICTIM_REPEATS;pass++){
+      for (i=0;i<lines;i++) __asm__ __volatile__("clflush (%0);" :: "r" (victims[i]) : "memory");
+      __asm__ __volatile__("mfence;":::"memory");
+      if (kind==VICTIM_CLEAN) {for (i=0;i<lines;i++) victim_sink+=*((volatile unsigned long long*)victims[i]);}
+      else for (i=0;i<lines;i++) *((volatile unsigned long long*)victims[i])=pass;
+      victim_sweep(buffer,buffer+victim_size,victims,lines,way_size,l2_ways,conflict);
+      /* reverse order, the next line is not the one evicted last */
+      for (i=0;i<lines;i++) samples[pass*lines+i]=victim_latency(victims[lines-1-i]);
+    }
+    /* latencies of each source are collected in sorted */
+    j=0;
+    for (src=0;src<VICTIM_SOURCES;src++){
+      n[src]=0;
+      for (i=0;i<VICTIM_REPEATS*lines;i++){
+        if (samples[i]<thresholds[0]) c=VICTIM_CACHED;
+        else if (samples[i]<thresholds[1]) c=VICTIM_LLC;
+        else c=VICTIM_DRAM;
+        if (c==src) sorted[j+n[src]++]=samples[i];
+      }
+      results[kind].lines[src]=n[src];
+      results[kind].latency[src]=median_latency(&sorted[j],n[src]);
+      j+=n[src];
+    }
+  }
+
+  free(victims);free(samples);free(sorted);
+  munmap(buffer,victim_size+sweep_size);
+  return conflict;
+}
+
+/** main loop of the helper processes, performs the data placement requested by thread id
+ *  the buffers are inherited shared mappings, so the addresses in the pointer chains are valid in both processes
+ *  the reply is the number of accesses of the chain, it is reduced if a DRAM or data structure chain is shorter, and the
+ *  accesses per node or lookup of a data structure chain
+ */
+static void helper_process(volatile mydata_t *data, int id)
+{
+  helper_request_t request;
+  threaddata_t *mydata=(threaddata_t*)&(data->threaddata[id]);
+  helper_reply_t reply;
+
+  prctl(PR_SET_PDEATHSIG,SIGKILL);
+  cpu_set(mydata->cpu_id);
+  if (data->SCHED_PRIO){
+    struct sched_param param;
+    param.sched_priority=data->SCHED_PRIO;
+    if (sched_setscheduler(0,SCHED_FIFO,&param)) {fprintf( stderr, "Warning: helper process %i could not switch to SCHED_FIFO\n",id ); fflush( stderr );}
+  }
+  /* the page list is private to this process */
+  data->page_address=NULL;
+
+  while (read(data->helpers[id].request_fd,&request,sizeof(request))==sizeof(request)){
+    accesses=request.accesses;
+    alignment=request.alignment;
+    data->page_address=(unsigned long long*)realloc(data->page_address,(request.memsize/data->pagesize+1)*sizeof(unsigned long long));
+    use_memory((void*)request.addr,mydata->cache_flush_area,request.memsize,request.mode,FIFO,request.num_uses,*(mydata->cpuinfo),data,NULL);
+    reply.accesses=accesses;
+    reply.structure_hops=buffer_owner(data,request.addr)->structure_hops;
+    if (write(data->helpers[id].reply_fd,&reply,sizeof(reply))!=sizeof(reply)) break;
+  }
+  _exit(0);
+}
+
+void start_helper_processes(volatile mydata_t *data)
+{
+  int i,t,request[2],reply[2];
+  pid_t pid;
+
+  for (t=1;t<data->num_threads;t++){
+    if (pipe(request)||pipe(reply)){
+      fprintf( stderr, "Error: could not create pipes for helper processes\n" ); fflush( stderr );
+      exit( 127 );
+    }
+    fflush(stdout);fflush(stderr);
+    pid=fork();
+    if (pid==-1){
+      fprintf( stderr, "Error: could not create helper process\n" ); fflush( stderr );
+      perror("fork");
+      exit( 127 );
+    }
+    if (pid==0){
+      close(request[1]);close(reply[0]);
+      /* the pipes of the other helpers must not be kept open, they would not see the end of file in stop_helper_processes() */
+      for (i=1;i<t;i++) {close(data->helpers[i].request_fd);close(data->helpers[i].reply_fd);}
+      data->helpers[t].request_fd=request[0];
+      data->helpers[t].reply_fd=reply[1];
+      helper_process(data,t);
+    }
+    close(request[0]);close(reply[1]);
+    data->helpers[t].pid=pid;
+    data->helpers[t].request_fd=request[1];
+    data->helpers[t].reply_fd=reply[0];
+  }
+}
+
+void stop_helper_processes(volatile mydata_t *data)
+{
+  int t;
+
+  for (t=1;t<data->num_threads;t++){
+    close(data->helpers[t].request_fd);
+    close(data->helpers[t].reply_fd);
+    waitpid(data->helpers[t].pid,NULL,0);
+  }
+}
+
+/** lets the helper process of thread id perform the data placement of the thread, blocks until it is finished
+ *  accesses is reduced to the length of the chain in the helper process and the accesses per node or lookup of a data
+ *  structure chain are stored for the buffer, as if the chain had been built by a thread
+ */
+static void helper_use_memory(volatile mydata_t *data, int id, threaddata_t *mydata)
+{
+  helper_request_t request;
+  helper_reply_t reply;
+
+  request.addr=mydata->aligned_addr;
+  request.memsize=mydata->memsize;
+  request.accesses=accesses;
+  request.alignment=alignment;
+  request.mode=mydata->USE_MODE;
+  request.num_uses=mydata->NUM_USES;
+  if ((write(data->helpers[id].request_fd,&request,sizeof(request))!=sizeof(request))||(read(data->helpers[id].reply_fd,&reply,sizeof(reply))!=sizeof(reply))){
+    fprintf( stderr, "Error: helper process of thread %i terminated\n",id ); fflush( stderr );
+    exit( 1 );
+  }
+  if (reply.accesses<accesses) accesses=reply.accesses;
+  buffer_owner(data,request.addr)->structure_hops=reply.structure_hops;
+  /* the lines of the chain are recorded in the helper process, BENCHIT_KERNEL_FLUSH_TARGETED has to evict all sets */
+  num_chain_lines=0;
+}
+
+/** load on the SMT sibling (BENCHIT_KERNEL_SMT_LOAD), runs until stop_smt_load() is called */
+static void *smt_load(void *arg)
+{
+  unsigned long long i,count=0,stride,n,a=0,b=0,c=0,d=0,sum=0;
+  volatile unsigned long long *buffer=NULL;
+
+  cpu_set(smt_cpu);
+  /* replaces the memory binding inherited from bi_init(), the buffer is local to the sibling */
+  numa_set_localalloc();
+  if (smt_mode!=SMT_LOAD_ALU){
+    buffer=(volatile unsigned long long*)mmap(NULL,smt_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (buffer==(void*)MAP_FAILED){
+      fprintf( stderr, "Error: Allocation of the SMT load buffer failed\n" ); fflush( stderr );
+      perror("mmap");
+      exit( 127 );
+    }
+    for (i=0;i<smt_size/sizeof(unsigned long long);i++) buffer[i]=i;
   }
+  stride=(smt_mode==SMT_LOAD_L1)?1:(STRIDE/sizeof(unsigned long long));
+  n=smt_size/sizeof(unsigned long long);
+
+  gettimeofday(&smt_start,(struct timezone *) 0);
+  smt_ready=1;
+  while(!smt_stop){
+    if (smt_mode==SMT_LOAD_ALU){
+      /* 4 independent dependency chains, 5 instructions per iteration */
+      i=100000;
+      __asm__ __volatile__(
+                "1:\n\t"
+                "add $1,%0;\n\t"
+                "add $1,%1;\n\t"
+                "add $1,%2;\n\t"
+                "add $1,%3;\n\t"
+                "dec %4;\n\t"
+                "jnz 1b;\n\t"
+                : "+r" (a), "+r" (b), "+r" (c), "+r" (d), "+r" (i)
+      );
+      count+=500000;
+    }
+    else {
+      for (i=0;i<n;i+=stride) sum+=buffer[i];
+      count+=smt_size;
+    }
+  }
+  gettimeofday(&smt_end,(struct timezone *) 0);
+  smt_count=count;
+  smt_sum=sum;
+
+  if (buffer!=NULL) munmap((void*)buffer,smt_size);
+  return NULL;
 }
 
+void start_smt_load(int cpu, int mode, unsigned long long size)
+{
+  smt_cpu=cpu;
+  smt_mode=mode;
+  smt_size=size;
+  smt_stop=0;
+  smt_ready=0;
+  if (pthread_create(&smt_thread,NULL,smt_load,NULL)){
+    fprintf( stderr, "Error: could not create SMT load thread\n" ); fflush( stderr );
+    exit( 127 );
+  }
+  /* the buffer is initialized before the measurement starts */
+  while(!smt_ready) usleep(1000);
+}
+
+double stop_smt_load(void)
+{
+  double time;
+
+  smt_stop=1;
+  pthread_join(smt_thread,NULL);
+  time=(smt_end.tv_sec-smt_start.tv_sec)+(smt_end.tv_usec-smt_start.tv_usec)/1000000.0;
+  if (time<=0) return 0;
+  return smt_count/time;
+}
 
 /** loop for additional worker threads
  *  communicating with master thread using shared variables
@@ -1219,7 +3373,7 @@ void *thread(void *threaddata)
 
   struct timespec wait_ns;
   int j,k,fd;
-  double tmp=(double)0;
+  volatile double tmp=(double)0; /* delay loops between polls of thread_comm */
   unsigned long long i,tmp2,tmp3,old=THREAD_STOP;
   
   wait_ns.tv_sec=0;
@@ -1242,7 +3396,15 @@ void *thread(void *threaddata)
 
   if(mydata->buffersize)
   {
-    if (global_data->hugepages==HUGEPAGES_OFF) mydata->buffer = (void *) _mm_malloc( mydata->buffersize,mydata->alignment);
+    if ((global_data->hugepages==HUGEPAGES_OFF)&&(global_data->PROCESS_MODE)){
+      mydata->buffer = alloc_shared_buffer(mydata->buffersize);
+      if (mydata->buffer==NULL){
+        fprintf( stderr, "Allocation of buffer failed\n" ); fflush( stderr );
+        perror("memfd_create");
+        exit( 127 );
+      }
+    }
+    else if (global_data->hugepages==HUGEPAGES_OFF) mydata->buffer = (void *) _mm_malloc( mydata->buffersize,mydata->alignment);
     if (global_data->hugepages==HUGEPAGES_ON)
     {
       char *dir;
@@ -1257,22 +3419,26 @@ void *thread(void *threaddata)
         perror("open");
         exit( 127 );
       } 
-      mydata->buffer=(char*) mmap(NULL,mydata->buffersize,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+      if (global_data->LAZY_INIT) mydata->buffer=(char*) mmap(NULL,mydata->buffersize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_NORESERVE,fd,0);
+      else mydata->buffer=(char*) mmap(NULL,mydata->buffersize,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
       close(fd);unlink(filename);
     } 
-    //fill buffer
-   /* initialize buffer */
-   tmp=sizeof(unsigned long long);
-   for (i=0;i<=mydata->buffersize-tmp;i+=tmp){
-      *((unsigned long long*)((unsigned long long)mydata->buffer+i))=(unsigned long long)i;
-   }
-
-    clflush(mydata->buffer,mydata->buffersize,*(mydata->cpuinfo));
+    //fill buffer, postponed to the first use if BENCHIT_KERNEL_LAZY_INIT is set
+    mydata->initialized=0;
+    if (!global_data->LAZY_INIT) init_buffer(mydata->buffer,mydata->buffersize,&(mydata->initialized),mydata->buffersize,mydata->cpuinfo);
     mydata->aligned_addr=(unsigned long long)(mydata->buffer) + mydata->offset;
   }
   else mydata->aligned_addr=(unsigned long long)(global_data->buffer) + mydata->offset; 
 
   cpu_set(((threaddata_t *) threaddata)->cpu_id);
+
+  /* real-time priority, see BENCHIT_KERNEL_SCHED_FIFO */
+  if (global_data->SCHED_PRIO){
+    struct sched_param param;
+    param.sched_priority=global_data->SCHED_PRIO;
+    if (pthread_setschedparam(pthread_self(),SCHED_FIFO,&param)) {fprintf( stderr, "Warning: thread %i could not switch to SCHED_FIFO\n",id ); fflush( stderr );}
+  }
+
   while(1)
   {
      switch (global_data->thread_comm[id]){
@@ -1282,8 +3448,9 @@ void *thread(void *threaddata)
            old=THREAD_USE_MEMORY;
            global_data->ack=id;
 
-           // use memory
-           use_memory((void*)mydata->aligned_addr,mydata->cache_flush_area,mydata->memsize,mydata->USE_MODE,FIFO,mydata->NUM_USES,*(mydata->cpuinfo),global_data,mydata);
+           // use memory, in a separate address space if BENCHIT_KERNEL_PROCESS_MODE is set
+           if (global_data->PROCESS_MODE) helper_use_memory(global_data,id,mydata);
+           else use_memory((void*)mydata->aligned_addr,mydata->cache_flush_area,mydata->memsize,mydata->USE_MODE,FIFO,mydata->NUM_USES,*(mydata->cpuinfo),global_data,mydata);
            global_data->done=id;
          }
          else 
@@ -1319,6 +3486,95 @@ void *thread(void *threaddata)
            tmp=100;while(tmp>0) tmp--; 
          }        
          break;
+       case THREAD_READ_CONCURRENT: 
+         if (old!=THREAD_READ_CONCURRENT)
+         {
+           old=THREAD_READ_CONCURRENT;
+           global_data->ack=id;
+
+           //follow the pointer chain together with the measuring thread (skipped if the measurement is already over, read_addr=0 reports it)
+           while ((!global_data->start)&&(global_data->thread_comm[id]==THREAD_READ_CONCURRENT));
+           if (global_data->start){
+             tmp2=mydata->read_addr;
+             for (i=0;i<mydata->accesses;i++) tmp2=*((volatile unsigned long long*)tmp2);
+             mydata->read_addr=tmp2;
+           }
+           else mydata->read_addr=0;
+         }
+         else 
+         {
+           tmp=100;while(tmp>0) tmp--; 
+         }        
+         break;
+       case THREAD_INIT_BUFFER: 
+         if (old!=THREAD_INIT_BUFFER)
+         {
+           old=THREAD_INIT_BUFFER;
+           global_data->ack=id;
+
+           if (mydata->buffersize) init_buffer(mydata->buffer,mydata->buffersize,&(mydata->initialized),mydata->offset+mydata->memsize,mydata->cpuinfo);
+         }
+         else 
+         {
+           tmp=100;while(tmp>0) tmp--; 
+         }        
+         break;
+       case THREAD_PAGE_FAULT: 
+         if (old!=THREAD_PAGE_FAULT)
+         {
+           old=THREAD_PAGE_FAULT;
+           global_data->ack=id;
+
+           page_fault_latency(mydata->memsize,global_data->PAGE_FAULT_MODE,mydata);
+           global_data->done=id;
+         }
+         else 
+         {
+           tmp=100;while(tmp>0) tmp--; 
+         }        
+         break;
+       case THREAD_CODE_LATENCY: 
+         if (old!=THREAD_CODE_LATENCY)
+         {
+           old=THREAD_CODE_LATENCY;
+           global_data->ack=id;
+
+           code_latency(mydata->memsize,mydata->accesses,global_data->CODE_LATENCY,global_data,mydata);
+           global_data->done=id;
+         }
+         else 
+         {
+           tmp=100;while(tmp>0) tmp--; 
+         }        
+         break;
+       case THREAD_WAKEUP: 
+         if (old!=THREAD_WAKEUP)
+         {
+           old=THREAD_WAKEUP;
+           global_data->ack=id;
+
+           wakeup_target();
+           global_data->done=id;
+         }
+         else 
+         {
+           tmp=100;while(tmp>0) tmp--; 
+         }        
+         break;
+       case THREAD_SWEEP: 
+         if (old!=THREAD_SWEEP)
+         {
+           old=THREAD_SWEEP;
+           global_data->ack=id;
+
+           sweep_latency(global_data,mydata);
+           mydata->sweep_busy=0;
+         }
+         else 
+         {
+           tmp=100;while(tmp>0) tmp--; 
+         }        
+         break;
        case THREAD_WAIT: // waiting
           if (old!=THREAD_WAIT) {
              global_data->ack=id;old=THREAD_WAIT;
@@ -1330,7 +3586,7 @@ void *thread(void *threaddata)
           break;
        case THREAD_STOP: // exit
        default:
-         if (global_data->hugepages==HUGEPAGES_ON)
+         if ((global_data->hugepages==HUGEPAGES_ON)||(global_data->PROCESS_MODE))
          {
            if(mydata->buffer!=NULL) munmap((void*)mydata->buffer,mydata->buffersize);
          }
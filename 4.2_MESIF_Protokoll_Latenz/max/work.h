@@ -22,6 +22,9 @@
 #define Y_AXIS_TEXT_1       "latency [ns]"
 #define Y_AXIS_TEXT_2       "latency [cycles]"
 #define Y_AXIS_TEXT_3       "counter value/ memory accesses"
+#define Y_AXIS_TEXT_4       "rejected runs"
+#define Y_AXIS_TEXT_5       "time per GiB [ms]"
+#define X_AXIS_TEXT_WAKEUP  "idle period [ns]"
 
 /* serialization method */
 #if defined(FORCE_CPUID)
@@ -42,6 +45,9 @@
 #define LOOP_OVERHEAD_COMP 0x100
 #define OPT_FLUSH_CPU0  0x200
 #define RESTORE_TLB        0x400
+#define VERIFY_PLACEMENT   0x800
+#define REJECT_MISPLACED   0x1000
+#define TARGETED_EVICTION  0x2000
 #define FLUSH(X)  (1<<(X-1))
 
 #define HUGEPAGES_OFF  0x01
@@ -50,6 +56,119 @@
 #define LIFO           0x01
 #define FIFO           0x02
 
+/* noise rejection (BENCHIT_KERNEL_NOISE_REJECTION) */
+#define NOISE_REJECTION_OFF    0x00
+#define NOISE_REJECTION_ON     0x01
+#define NOISE_REJECTION_STRICT 0x02
+
+/* first-touch latency (BENCHIT_KERNEL_PAGE_FAULT_MODE) */
+#define PAGE_FAULT_OFF      0x00
+#define PAGE_FAULT_4K       0x01
+#define PAGE_FAULT_THP      0x02
+#define PAGE_FAULT_HUGETLB  0x03
+#define PAGE_FAULT_POPULATE 0x04
+#define PAGE_FAULT_WILLNEED 0x05
+#define HUGEPAGE_SIZE       (2*1024*1024)
+
+/* instruction fetch latency (BENCHIT_KERNEL_CODE_LATENCY) */
+#define CODE_LATENCY_OFF     0x00
+#define CODE_LATENCY_4K      0x01
+#define CODE_LATENCY_THP     0x02
+#define CODE_LATENCY_HUGETLB 0x03
+
+/* load on the SMT sibling of the measuring CPU (BENCHIT_KERNEL_SMT_LOAD) */
+#define SMT_LOAD_OFF  0x00
+#define SMT_LOAD_ALU  0x01
+#define SMT_LOAD_L1   0x02
+#define SMT_LOAD_L2   0x03
+#define SMT_LOAD_DRAM 0x04
+
+/* DRAM address mapping (BENCHIT_KERNEL_DRAM_MODE) */
+#define DRAM_MODE_OFF          0x00
+#define DRAM_MODE_ROW_HIT      0x01
+#define DRAM_MODE_ROW_CONFLICT 0x02
+#define DRAM_MODE_BANK_SPREAD  0x03
+#define DRAM_MAX_FUNCTIONS     16
+
+/* linked data structure layouts (BENCHIT_KERNEL_STRUCTURE) */
+#define STRUCTURE_OFF          0x00
+#define STRUCTURE_BTREE_64     0x01
+#define STRUCTURE_BTREE_128    0x02
+#define STRUCTURE_BTREE_256    0x03
+#define STRUCTURE_BTREE_512    0x04
+#define STRUCTURE_HASH_OPEN    0x05
+#define STRUCTURE_HASH_CHAINED 0x06
+#define STRUCTURE_TREE_AOS     0x07
+#define STRUCTURE_TREE_SOA     0x08
+
+/* wake-up latency (BENCHIT_KERNEL_WAKEUP_MODE) */
+#define WAKEUP_OFF     0x00
+#define WAKEUP_FUTEX   0x01
+#define WAKEUP_EVENTFD 0x02
+#define WAKEUP_PIPE    0x03
+
+/* fences and serializing instructions (BENCHIT_KERNEL_FENCE_COST, BENCHIT_KERNEL_COMPUTE_MODE) */
+#define FENCE_NONE      0
+#define FENCE_MFENCE    1
+#define FENCE_SFENCE    2
+#define FENCE_LFENCE    3
+#define FENCE_LOCK      4
+#define FENCE_XCHG      5
+#define FENCE_CPUID     6
+#define FENCE_SERIALIZE 7
+#define FENCE_TYPES     8
+/* operations before each fence: none, stores to L1, loads that miss all caches, dependent loads from L1 */
+#define FENCE_CONTEXT_NONE   0
+#define FENCE_CONTEXT_STORES 1
+#define FENCE_CONTEXT_MISSES 2
+#define FENCE_CONTEXT_CHASE  3
+#define FENCE_CONTEXTS       4
+
+/* software prefetch instructions (BENCHIT_KERNEL_PREFETCH_ADVISOR) */
+#define PREFETCH_NONE  0
+#define PREFETCH_T0    1
+#define PREFETCH_T1    2
+#define PREFETCH_T2    3
+#define PREFETCH_NTA   4
+#define PREFETCH_W     5
+#define PREFETCH_TYPES 6
+/* access patterns: gathers through an index array, pointer chain with jump pointers */
+#define PREFETCH_OFF   0x00
+#define PREFETCH_INDEX 0x01
+#define PREFETCH_CHAIN 0x02
+
+/* store/load pairs (BENCHIT_KERNEL_STORE_FORWARDING) */
+#define FORWARD_MATCHED_8     0    /* 8 Byte store and load, same address */
+#define FORWARD_MATCHED_4     1
+#define FORWARD_MATCHED_1     2
+#define FORWARD_CONTAINED_0   3    /* 4 Byte load from the first half of an 8 Byte store */
+#define FORWARD_CONTAINED_4   4    /* 4 Byte load from the second half of an 8 Byte store */
+#define FORWARD_CONTAINED_7   5    /* 1 Byte load from the last Byte of an 8 Byte store */
+#define FORWARD_WIDER         6    /* 8 Byte load from a 4 Byte store */
+#define FORWARD_OVERLAP       7    /* 8 Byte load that overlaps the second half of an 8 Byte store */
+#define FORWARD_MISALIGNED_1  8    /* 8 Byte store and load at offset 1 within a cacheline */
+#define FORWARD_MISALIGNED_5  9
+#define FORWARD_LINE_SPLIT_8  10   /* 8 Byte store and load crossing a cacheline */
+#define FORWARD_LINE_SPLIT_4  11
+#define FORWARD_PAGE_SPLIT    12   /* 8 Byte store and load crossing a page */
+#define FORWARD_CASES         13
+
+/* interleaved lookups (BENCHIT_KERNEL_INTERLEAVED_LOOKUPS) */
+#define INTERLEAVED_MAX_GROUPS    32
+#define INTERLEAVED_LOOKUP_LENGTH 4    /* dependent accesses per lookup */
+
+/* largest data set of the prefetch advisor and the interleaved lookups (memory level) */
+#define ANALYSIS_MAX_SIZE (1024ULL*1024*1024)
+
+/* L2 victims (BENCHIT_KERNEL_VICTIM_PATH) */
+#define VICTIM_CLEAN   0    /* lines loaded before the eviction */
+#define VICTIM_DIRTY   1    /* lines written before the eviction */
+#define VICTIM_KINDS   2
+#define VICTIM_CACHED  0    /* line has not been evicted from L1/L2 */
+#define VICTIM_LLC     1
+#define VICTIM_DRAM    2
+#define VICTIM_SOURCES 3
+
 /* coherency states */
 #define MODE_EXCLUSIVE 0x01
 #define MODE_MODIFIED  0x02
@@ -69,6 +188,12 @@
 #define THREAD_PREFETCH_CODE   5
 #define THREAD_FLUSH           6
 #define THREAD_FLUSH_ALL       7
+#define THREAD_READ_CONCURRENT 8
+#define THREAD_INIT_BUFFER     9
+#define THREAD_PAGE_FAULT      10
+#define THREAD_CODE_LATENCY    11
+#define THREAD_SWEEP           12
+#define THREAD_WAKEUP          13
 
 /* default value for accessing each cacheline - updated with hw_detect information if available */
 #define STRIDE        64
@@ -91,7 +216,146 @@
 #define _donop(x) _nop ## x       //_donop(n)     -> _nopn
 #define NOP(x) _donop(x)          //NOP(NOPCOUNT) -> _donop(n)
 
+/* definitions to add the selected number of ALU or FP operations (BENCHIT_KERNEL_COMPUTE_OPS) after each memory reference
+ * independent operations (default) use 8 registers that are not part of the pointer chain,
+ * dependent operations (COMPUTE_DEPENDENT) modify the pointer without changing its value, FP operations (COMPUTE_FP)
+ * multiply by 1.0, the dependent version converts the pointer to double and back for that
+ * ALU operations add a zeroed register, additions of immediates can be eliminated during renaming on recent cores */
+#ifndef COMPUTE_OPS
+#define COMPUTE_OPS 0
+#endif
+#define _str(x) #x
+#define STR(x) _str(x)
+#if defined(COMPUTE_FP) && defined(COMPUTE_DEPENDENT) && (COMPUTE_OPS>0)
+#define COMPUTE_INIT "mov $1,%%r8;cvtsi2sd %%r8,%%xmm1;"
+#define COMPUTE(x) "cvtsi2sd %%rbx,%%xmm0;.rept "STR(x)";mulsd %%xmm1,%%xmm0;.endr;cvttsd2si %%xmm0,%%rbx;"
+#elif defined(COMPUTE_FP)
+#define COMPUTE_INIT "mov $1,%%r8;cvtsi2sd %%r8,%%xmm1;" \
+                "movapd %%xmm1,%%xmm2;movapd %%xmm1,%%xmm3;movapd %%xmm1,%%xmm4;movapd %%xmm1,%%xmm5;" \
+                "movapd %%xmm1,%%xmm6;movapd %%xmm1,%%xmm7;movapd %%xmm1,%%xmm8;movapd %%xmm1,%%xmm9;"
+#define COMPUTE(x) ".rept ("STR(x)")/8;" \
+                "mulsd %%xmm1,%%xmm2;mulsd %%xmm1,%%xmm3;mulsd %%xmm1,%%xmm4;mulsd %%xmm1,%%xmm5;" \
+                "mulsd %%xmm1,%%xmm6;mulsd %%xmm1,%%xmm7;mulsd %%xmm1,%%xmm8;mulsd %%xmm1,%%xmm9;" \
+                ".endr;.rept ("STR(x)")%%8;mulsd %%xmm1,%%xmm2;.endr;"
+#elif defined(COMPUTE_FENCE)
+/* fences do not depend on the pointer, they delay the next load (mfence, lfence, locked instructions, serializing
+ * instructions) or not (sfence), lock and xchg access the stack without changing it, cpuid saves the pointer, the
+ * loop counter and the start timestamp in r13-r15 (pushes would overwrite the red zone of asm_work_mov_cycles()) */
+#if COMPUTE_FENCE==FENCE_MFENCE
+#define COMPUTE_FENCE_INSN "mfence;"
+#elif COMPUTE_FENCE==FENCE_SFENCE
+#define COMPUTE_FENCE_INSN "sfence;"
+#elif COMPUTE_FENCE==FENCE_LFENCE
+#define COMPUTE_FENCE_INSN "lfence;"
+#elif COMPUTE_FENCE==FENCE_LOCK
+#define COMPUTE_FENCE_INSN "lock addq $0,(%%rsp);"
+#elif COMPUTE_FENCE==FENCE_XCHG
+#define COMPUTE_FENCE_INSN "xchg %%rdx,(%%rsp);"
+#elif COMPUTE_FENCE==FENCE_CPUID
+#define COMPUTE_FENCE_INSN "mov %%rax,%%r13;mov %%rbx,%%r14;mov %%rcx,%%r15;xor %%eax,%%eax;cpuid;mov %%r13,%%rax;mov %%r14,%%rbx;mov %%r15,%%rcx;"
+#else
+#define COMPUTE_FENCE_INSN ".byte 0x0f,0x01,0xe8;"
+#endif
+#define COMPUTE_INIT "mov (%%rsp),%%rdx;"
+#define COMPUTE(x) ".rept "STR(x)";"COMPUTE_FENCE_INSN".endr;"
+#elif defined(COMPUTE_DEPENDENT)
+#define COMPUTE_INIT "xor %%edx,%%edx;"
+#define COMPUTE(x) ".rept "STR(x)";add %%rdx,%%rbx;.endr;"
+#else
+#define COMPUTE_INIT "xor %%edx,%%edx;"
+#define COMPUTE(x) ".rept ("STR(x)")/8;" \
+                "add %%rdx,%%r8;add %%rdx,%%r9;add %%rdx,%%r10;add %%rdx,%%r11;" \
+                "add %%rdx,%%r12;add %%rdx,%%r13;add %%rdx,%%r14;add %%rdx,%%r15;" \
+                ".endr;.rept ("STR(x)")%%8;add %%rdx,%%r8;.endr;"
+#endif
+
+
+
+/* time-series sampling (BENCHIT_KERNEL_SAMPLE_*) */
+/* header of the binary sample file, followed by sample_t records */
+typedef struct sample_file_header
+{
+   char magic[8];                       /* "BILATSMP" */
+   unsigned int version;                /* 1 */
+   unsigned int record_size;            /* sizeof(sample_t) */
+   unsigned long long clockrate;        /* TSC ticks per second */
+   unsigned long long memsize;          /* data set size in Byte */
+   unsigned int accesses;               /* accesses per sample */
+   unsigned int use_mode;               /* coherency state (MODE_*) */
+} sample_file_header_t;
 
+typedef struct sample
+{
+   unsigned long long tsc;              /* timestamp at the start of the sample */
+   int cycles;                          /* average latency of the accesses in the sample */
+   unsigned short cpu;                  /* CPU that holds the data */
+   unsigned short reserved;
+} sample_t;
+
+typedef struct sampling
+{
+   unsigned long long duration;         /* TSC ticks per CPU */
+   unsigned long long max_samples;
+   unsigned long long num_samples;
+   unsigned long long *segments;        /* start addresses of pointer chain segments, set by use_memory() */
+   unsigned int passes;                 /* 24 accesses per pass */
+   sample_t *samples;
+   int fd;
+} sampling_t;
+
+/* helper processes (BENCHIT_KERNEL_PROCESS_MODE) */
+typedef struct helper_request
+{
+   unsigned long long addr;
+   unsigned long long memsize;
+   unsigned int accesses;
+   unsigned int alignment;
+   int mode;
+   int num_uses;
+} helper_request_t;
+
+typedef struct helper_reply
+{
+   unsigned int accesses;               /* length of the chain */
+   double structure_hops;               /* accesses per node or lookup of a data structure chain */
+} helper_reply_t;
+
+typedef struct helper
+{
+   pid_t pid;
+   int request_fd;                      /* written by the thread, read by the helper process */
+   int reply_fd;                        /* written by the helper process when the data placement is finished */
+} helper_t;
+
+/* page placement of a buffer (BENCHIT_KERNEL_VERIFY_PLACEMENT), counted in base pages */
+#define PLACEMENT_MAX_NODES 64
+typedef struct placement
+{
+   unsigned long long pages;
+   unsigned long long not_present;
+   unsigned long long unknown_node;                     /* move_pages() failed or node >= PLACEMENT_MAX_NODES */
+   unsigned long long small_pages;
+   unsigned long long huge_pages;                       /* base pages backed by hugetlbfs or transparent huge pages */
+   unsigned long long unknown_size;                     /* PFNs in /proc/self/pagemap require CAP_SYS_ADMIN */
+   unsigned long long wrong_node;
+   unsigned long long nodes[PLACEMENT_MAX_NODES];
+} placement_t;
+
+/* measurement scenario (BENCHIT_KERNEL_SCENARIO_FILE), the settings that can differ between the scenarios of one run */
+typedef struct scenario
+{
+   char name[64];
+   int use_mode;
+   int num_uses;
+   int flush_mode;
+   int num_flushes;
+   int flush_levels[4];                 /* BENCHIT_KERNEL_FLUSH_L1 to BENCHIT_KERNEL_FLUSH_L4 */
+   unsigned int flush_settings;         /* FLUSH() bits of the available levels, set in bi_init() */
+   int alignment;
+   int num_threads;                     /* number of CPUs in the CPU_LIST of the scenario */
+   int *threads;                        /* thread ids in the order of the CPU_LIST of the scenario */
+   unsigned char *measured;             /* 1 for the threads that are measured, indexed by thread id */
+} scenario_t;
 
 /** The data structure that holds all the global data.
  */
@@ -124,7 +388,17 @@ typedef struct mydata
    unsigned char FLUSH_PT;                              //+4
    unsigned char ENABLE_CODE_PREFETCH;
    unsigned char USE_MODE;                              //+2
-   unsigned char padding1[19];                          //+19 = 128
+   unsigned char NOISE_REJECTION;
+   unsigned short NOISE_RETRIES;
+   unsigned char SCHED_PRIO;                            //+4
+   unsigned char SHARER_SCALING;
+   unsigned char CONCURRENT_READERS;
+   unsigned char LAZY_INIT;
+   unsigned char PAGE_FAULT_MODE;                       //+4
+   unsigned char PROCESS_MODE;
+   unsigned char CODE_LATENCY;
+   unsigned char NUM_SWEEP_CPUS;                        //+3
+   helper_t *helpers;                                   //+8 = 128
    unsigned long long dummy_cachelines1[16];            // separate exclusive data from shared data
    #ifdef USE_PAPI
    long long *values;
@@ -132,13 +406,18 @@ typedef struct mydata
    int Eventset;
    int num_events;                                      //(24) 
    #endif
-   int *thread_comm;                                    //+8   
+   volatile int *thread_comm;                           //+8   
+   double *noise_results;                               //+8
+   sampling_t *sampling;                                //+8
+   double *fault_results;                               //+8
    volatile unsigned short ack;
-   volatile unsigned short done;                        //+4 
+   volatile unsigned short done;
+   volatile unsigned short start;                       //+6 
+   unsigned char skip_local;                            //+1
    #ifdef USE_PAPI
-   unsigned char padding2[28];                          //24+8+4+28 = 64
+   unsigned char padding2[1];                           //24+8+8+8+8+6+1+1 = 64
    #else
-   unsigned char padding2[52];                          //   8+4+52 = 64
+   unsigned char padding2[25];                          //   8+8+8+8+6+1+25 = 64
    #endif
    unsigned long long end_dummy_cachelines[16];         // avoid prefetching other memory when accessing mydata_t structure
 } mydata_t;
@@ -165,7 +444,18 @@ typedef struct threaddata
    unsigned char NUM_USES;
    unsigned char FLUSH_MODE;                            //+3
    unsigned char USE_MODE;                              //+1
-   unsigned char padding1[32];                          //+32 = 128
+   unsigned long long read_addr;
+   unsigned long long initialized;                      //+16
+   unsigned long long fault_latency;
+   unsigned long long fault_duration;                   //+16 = 128
+   unsigned long long code_latency;                     //+8
+   unsigned long long sweep_latency;
+   unsigned int sweep_runs;
+   unsigned int sweep_alignment;
+   volatile unsigned int sweep_busy;
+   unsigned int misplaced;                              //+24
+   double structure_hops;                               //+8, accesses per node or lookup of the chain in the buffer (BENCHIT_KERNEL_STRUCTURE)
+   unsigned char padding1[24];                          //+24 = 64
    unsigned long long end_dummy_cachelines[16];         //avoid prefetching following data 
 } threaddata_t;
 
@@ -179,9 +469,186 @@ void _random_init(int start,int max);
  */
 unsigned long long _random(void);
 
-/* measure overhead of empty loop */
+/** fills the buffer up to the given size and removes it from the caches, only the part that has not been
+ *  initialized before is touched (BENCHIT_KERNEL_LAZY_INIT)
+ *  @param initialized number of bytes that are already initialized, updated by this function
+ */
+void init_buffer(char *buffer, unsigned long long buffersize, unsigned long long *initialized, unsigned long long size, cpu_info_t *cpuinfo);
+
+/** allocates a buffer that is shared with the helper processes (memfd)
+ *  @return NULL if the allocation failed
+ */
+char *alloc_shared_buffer(unsigned long long size);
+
+/** forks one helper process for each thread, the helper processes are bound to the CPUs of the threads
+ *  and perform the data placement for them (BENCHIT_KERNEL_PROCESS_MODE)
+ */
+void start_helper_processes(volatile mydata_t *data);
+
+/** terminates the helper processes */
+void stop_helper_processes(volatile mydata_t *data);
+
+/** starts the measurement of the local latency of memsize on sweep CPU t, does not wait for the result
+ *  (BENCHIT_KERNEL_SWEEP_CPU_LIST)
+ */
+void start_sweep(volatile mydata_t *data, int t, unsigned long long memsize, int def_alignment, int num_accesses, int runs);
+
+/** waits for the measurement on sweep CPU t
+ *  @return latency in cycles, 0 if the measurement failed
+ */
+unsigned long long finish_sweep(volatile mydata_t *data, int t);
+
+/** determines the NUMA node and page size of the pages of size Byte starting at buffer
+ *  (move_pages(), /proc/self/pagemap, /proc/kpageflags)
+ *  @return number of present pages that are not located on node or are no huge pages although huge is set
+ */
+unsigned long long check_placement(char *buffer, unsigned long long size, int node, int huge, placement_t *placement);
+
+/** sets the seed for the random pointer chains and the directory for cached chains
+ *  (BENCHIT_KERNEL_SEED, BENCHIT_KERNEL_CHAIN_CACHE_DIR), seed 0 selects time based seeds, cache_dir NULL disables the cache
+ */
+void set_chain_options(unsigned long long seed, char *cache_dir);
+
+/** starts a thread on cpu that generates load until stop_smt_load() is called (BENCHIT_KERNEL_SMT_LOAD)
+ *  - SMT_LOAD_ALU: independent integer additions
+ *  - SMT_LOAD_L1, SMT_LOAD_L2, SMT_LOAD_DRAM: reads a buffer of size Byte in a loop (every 8 Byte for L1, one read per cacheline otherwise)
+ */
+void start_smt_load(int cpu, int mode, unsigned long long size);
+
+/** stops the load thread
+ *  @return processed Byte (instructions for SMT_LOAD_ALU) per second
+ */
+double stop_smt_load(void);
+
+/** sets the DRAM address mapping used to build the pointer chains (BENCHIT_KERNEL_DRAM_MODE)
+ *  bank bit i is the parity of (physical address & functions[i]), the row is physical address >> row_shift
+ */
+void set_dram_options(int mode, unsigned long long *functions, int num_functions, int row_shift);
+
+/** selects the linked data structure that is emulated by the pointer chains (BENCHIT_KERNEL_STRUCTURE)
+ *  the chains contain the dependent accesses of lookups in the structure, the latencies are reported per node or lookup
+ */
+void set_structure_options(int mode);
+
+/** determines the DRAM bank functions from the latency of access pairs (BENCHIT_KERNEL_DRAM_SOLVE)
+ *  - accesses to different rows of the same bank are slower than all other pairs (row conflict)
+ *  - lines in a buffer of size Byte are grouped into banks, XOR functions of up to 4 bits that are constant within
+ *    each group are searched
+ *  @param threshold latency in cycles that separates row conflicts, 0 selects it from the largest gap of the latencies
+ *  @return number of functions, -1 if the physical addresses are not available
+ */
+int solve_dram_functions(unsigned long long size, int num_samples, unsigned long long threshold, unsigned long long *functions, int max_functions);
+
+/** selects the wake-up latency measurement (BENCHIT_KERNEL_WAKEUP_MODE), replaces the memory latency measurement
+ *  - the first CPU wakes each other selected CPU num_samples times after the idle period (problem size in ns)
+ *  - the median is reported as result, percentiles[0..2][t] are set to the 90th and 99th percentile and the maximum (cycles)
+ */
+void set_wakeup_options(int mode, int num_samples, double *percentiles);
+
+/** restricts _work() to the threads with measured[t]!=0 (BENCHIT_KERNEL_SCENARIO_FILE), NULL measures all threads
+ *  results of the other threads are not changed
+ */
+void set_measured_threads(unsigned char *measured);
+
+/** checks if the fence type is supported by the CPU (serialize requires CPUID.(EAX=7,ECX=0):EDX[14]) */
+int fence_supported(int type);
+
+/** measures the cost of fences and serializing instructions on the current CPU (BENCHIT_KERNEL_FENCE_COST)
+ *  - cycles[type*FENCE_CONTEXTS+context] is the minimal duration of one loop iteration with one instruction of type
+ *    after the context operations, FENCE_NONE measures the context operations alone, -1 for unsupported types
+ *  - outstanding misses are loads from a buffer of buffer_size Byte (power of 2) with a stride of 4 KiB + 64 Byte
+ */
+void measure_fences(unsigned long long buffer_size, unsigned long long iterations, double *cycles);
+
+/** checks if the prefetch instruction is supported by the CPU (prefetchw requires CPUID.(EAX=80000001H):ECX[8]) */
+int prefetch_supported(int type);
+
+/** measures software prefetching of pattern in a buffer of size Byte on the current CPU (BENCHIT_KERNEL_PREFETCH_ADVISOR)
+ *  - PREFETCH_INDEX: loads of cachelines in random order through an index array, the line distance accesses ahead is prefetched
+ *  - PREFETCH_CHAIN: random pointer chain, each line also points to the line distance accesses ahead (jump pointer),
+ *    which is prefetched
+ *  - cycles[type*num_distances+d] is the minimal duration per access with prefetch instruction type at distances[d],
+ *    PREFETCH_NONE measures the pattern without prefetches (same value for all distances), -1 for unsupported types
+ */
+void measure_prefetch(int pattern, unsigned long long size, unsigned long long accesses, int *distances, int num_distances, double *cycles);
+
+/** measures store-to-load forwarding on the current CPU (BENCHIT_KERNEL_STORE_FORWARDING)
+ *  - the loaded value is the data of the next store (dependency chain through memory)
+ *  - forwarded_cycles[c] is the minimal duration of a store/load pair of case c (FORWARD_*), the load uses base + index
+ *    addressing which prevents memory renaming
+ *  - renamed_cycles[c]: the load uses the base register only, CPUs with memory renaming can bypass the forwarding
+ */
+void measure_forwarding(unsigned long long iterations, double *renamed_cycles, double *forwarded_cycles);
+
+/** measures the 4K aliasing penalty on the current CPU (BENCHIT_KERNEL_STORE_FORWARDING)
+ *  - 8 Byte store followed by an 8 Byte load from the store address + distances[d], the next store address depends on the
+ *    loaded value, distances that are multiples of 4 KiB match the store in address bits 0-11 without a real dependency
+ *  - cycles[d] is the minimal duration of a store/load pair
+ */
+void measure_aliasing(unsigned long long iterations, int *distances, int num_distances, double *cycles);
+
+/** measures interleaved lookups in a buffer of size Byte on the current CPU (BENCHIT_KERNEL_INTERLEAVED_LOOKUPS)
+ *  - each lookup starts at a hashed line of a random pointer chain and follows INTERLEAVED_LOOKUP_LENGTH pointers
+ *  - groups[g] lookups are processed as state machines in round robin, each one prefetches its next line and
+ *    switches to the next lookup (asynchronous memory access chaining)
+ *  - cycles[g] is the minimal duration per access with groups[g] interleaved lookups
+ */
+void measure_interleaved(unsigned long long size, unsigned long long accesses, int *groups, int num_groups, double *cycles);
+
+/* sources of re-read L2 victims (BENCHIT_KERNEL_VICTIM_PATH) */
+typedef struct victim_result
+{
+   unsigned long long lines[VICTIM_SOURCES];     /* number of lines per source */
+   double latency[VICTIM_SOURCES];               /* median latency in cycles, 0 if no line came from the source */
+} victim_result_t;
+
+/** measures where lines evicted from L2 are found on the current CPU (BENCHIT_KERNEL_VICTIM_PATH)
+ *  - lines random cachelines are loaded (VICTIM_CLEAN) or written (VICTIM_DIRTY), evicted from L1 and L2 by reading
+ *    2*l2_ways lines per L2 set of each line (conflict sweep, requires huge pages) or 2 times the L2 size in scattered
+ *    order (full sweep), and read again in random order, the sweep does not fill the last level cache
+ *  - each load is timed separately (including the rdtsc latency), latencies below thresholds[0] are counted as
+ *    VICTIM_CACHED, below thresholds[1] as VICTIM_LLC, all others as VICTIM_DRAM
+ *  - thresholds[0] is set to twice the latency of L2 above an L1 hit (medians of lines that have not been evicted),
+ *    thresholds[1] to the middle between an L1 hit and the median latency of flushed lines if it is 0
+ *  @return 1 if the conflict sweep has been used, 0 for the full sweep
+ */
+int measure_victims(unsigned long long l2_size, unsigned long long l2_ways, unsigned long long lines, unsigned long long *thresholds, victim_result_t *results);
+
+/* measure overhead of empty loop (asm_work.c) */
 int asm_loop_overhead(int n);
 
+/** follows the pointer chain starting at addr for passes*24 accesses (asm_work.c)
+ *  @return average latency per access in cycles
+ */
+int asm_work_mov(unsigned long long addr, unsigned long long passes,volatile mydata_t *data);
+
+/** like asm_work_mov() (asm_work.c)
+ *  @return cycles of all passes*24 accesses (without the rdtsc latency)
+ */
+unsigned long long asm_work_mov_cycles(unsigned long long addr, unsigned long long passes,volatile mydata_t *data);
+
+/** calls the chain of jmp instructions starting at addr passes times (asm_work.c)
+ *  @param jumps number of jmp instructions in the chain, the last element of the chain is a ret instruction
+ *  @return average latency per jump in cycles
+ */
+int asm_work_jmp(unsigned long long addr, unsigned long long passes, unsigned long long jumps, volatile mydata_t *data);
+
+/** measures two independent loads of uncached lines and flushes them (asm_work.c)
+ *  @return cycles including the rdtsc latency
+ */
+unsigned long long asm_pair_latency(unsigned long long addr1, unsigned long long addr2);
+
+/** measures one load (asm_work.c)
+ *  @return cycles including the rdtsc latency
+ */
+unsigned long long asm_line_latency(unsigned long long addr);
+
+/** executes iterations loop iterations with the context operations and one instruction of the fence type (asm_work.c)
+ *  buffer provides mask+1 Byte for the outstanding misses, its first 1 KiB is also used by the other operations
+ *  @return cycles including the rdtsc latency
+ */
+unsigned long long asm_fence_loop(int type, int context, unsigned long long iterations, char *buffer, unsigned long long mask);
+
  
 /* function that performs the measurement */
 void _work(unsigned long long memsize, int def_alignment, int offset, int function, int num_accesses, int runs,volatile mydata_t* data, double ** results);
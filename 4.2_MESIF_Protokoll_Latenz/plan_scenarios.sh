@@ -0,0 +1,155 @@
+#!/bin/sh
+##################################################################################################################
+# derives BENCHIT_KERNEL_CPU_LIST settings from the topology in sysfs and runs the latency kernel once for every
+# relationship class and coherence state
+#
+# relationship classes (first CPU measures, second CPU holds the data):
+#   SMT          hardware threads of the same core
+#   P-P          P-cores, different cores
+#   E-E_cluster  E-cores sharing an L2 cache (same cluster)
+#   E-E_cross    E-cores in different L2 clusters
+#   P-E          P-core accessing data of an E-core
+#   E-P          E-core accessing data of a P-core
+# one representative pair is selected per class, classes that do not exist on the system are skipped
+#
+# usage: plan_scenarios.sh [-n] [-s "E M S F"] [-p PARAMETERS] [-b benchit_root] [-k kernel]
+#   -n  only print the plan
+#   -s  coherence states to measure (BENCHIT_KERNEL_USE_MODE, default "E M")
+#   -p  PARAMETERS file used as template (default: PARAMETERS of the kernel in the benchit folder)
+#   -b  benchit folder (default: current directory)
+#   -k  kernel (default: kernel/arch_x86-64/memory_latency/C/pthread/0/read)
+# S/F additionally require a third CPU, which is used as BENCHIT_KERNEL_SHARED_CPU_LIST, a CPU of the other core type is
+# used if all cores of the type of the data CPU are busy (e.g. E-E_cross on processors with two E-core clusters)
+# I requires BENCHIT_KERNEL_FLUSH_MODE="I", see README
+##################################################################################################################
+
+SYSFS=${SYSFS:-/sys/devices/system/cpu}
+DRY_RUN=0
+STATES="E M"
+BENCHIT_ROOT=`pwd`
+KERNEL="kernel/arch_x86-64/memory_latency/C/pthread/0/read"
+TEMPLATE=""
+
+while getopts "ns:p:b:k:" opt; do
+  case $opt in
+    n) DRY_RUN=1;;
+    s) STATES="$OPTARG";;
+    p) TEMPLATE="$OPTARG";;
+    b) BENCHIT_ROOT="$OPTARG";;
+    k) KERNEL="$OPTARG";;
+    *) sed -n '/^# usage/,/^# I requires/p' $0; exit 1;;
+  esac
+done
+if [ -z "$TEMPLATE" ]; then TEMPLATE="$BENCHIT_ROOT/$KERNEL/PARAMETERS"; fi
+
+# expands sysfs cpu lists ("0-3,8") into "0 1 2 3 8"
+expand_list()
+{
+  echo "$1" | tr ',' '\n' | while read range; do
+    [ -z "$range" ] && continue
+    first=${range%-*}
+    last=${range#*-}
+    seq $first $last
+  done | tr '\n' ' '
+}
+
+# checks if CPU $1 is contained in the expanded list $2
+in_list()
+{
+  for cpu in $2; do
+    [ "$cpu" = "$1" ] && return 0
+  done
+  return 1
+}
+
+# core type: hybrid CPUs list their E-cores in /sys/devices/cpu_atom/cpus, all other cores are reported as P-cores
+E_CORES=""
+if [ -r $SYSFS/../../cpu_atom/cpus ]; then E_CORES=`expand_list $(cat $SYSFS/../../cpu_atom/cpus)`; fi
+core_type()
+{
+  if in_list $1 "$E_CORES"; then echo E; else echo P; fi
+}
+
+# shared_cpu_list of the L2 cache of CPU $1
+l2_cpus()
+{
+  for idx in $SYSFS/cpu$1/cache/index*; do
+    if [ "`cat $idx/level`" = "2" ] && [ "`cat $idx/type`" != "Instruction" ]; then
+      cat $idx/shared_cpu_list
+      return
+    fi
+  done
+}
+
+classify()
+{
+  if in_list $2 "`expand_list $(cat $SYSFS/cpu$1/topology/thread_siblings_list)`"; then echo SMT; return; fi
+  ta=`core_type $1`
+  tb=`core_type $2`
+  if [ "$ta$tb" = "PP" ]; then echo P-P
+  elif [ "$ta$tb" = "EE" ]; then
+    if [ "`l2_cpus $1`" = "`l2_cpus $2`" ]; then echo E-E_cluster; else echo E-E_cross; fi
+  elif [ "$ta" = "P" ]; then echo P-E
+  else echo E-P
+  fi
+}
+
+CPUS=`expand_list $(cat $SYSFS/online)`
+
+# select one representative pair per class (lowest CPU numbers)
+PLAN=""
+for a in $CPUS; do
+  for b in $CPUS; do
+    [ "$a" = "$b" ] && continue
+    class=`classify $a $b`
+    case " $PLAN " in
+      *" $class:"*) ;;
+      *) PLAN="$PLAN $class:$a,$b";;
+    esac
+  done
+done
+
+echo "relationship classes:"
+for entry in $PLAN; do
+  echo "  ${entry%%:*}: BENCHIT_KERNEL_CPU_LIST=\"${entry#*:}\""
+done
+
+if [ $DRY_RUN -eq 0 ]; then
+  if [ ! -r "$TEMPLATE" ]; then echo "PARAMETERS file $TEMPLATE not found"; exit 1; fi
+  cd $BENCHIT_ROOT || exit 1
+  ./COMPILE.SH --parameter-file="$TEMPLATE" $KERNEL || exit 1
+fi
+
+for entry in $PLAN; do
+  class=${entry%%:*}
+  pair=${entry#*:}
+  for state in $STATES; do
+    shared=""
+    if [ "$state" = "S" ] || [ "$state" = "F" ]; then
+      # third CPU of the type of the data CPU, not on the cores of the pair and not sharing their L2 (E-core clusters)
+      busy="`expand_list $(cat $SYSFS/cpu${pair%,*}/topology/thread_siblings_list)` `expand_list $(cat $SYSFS/cpu${pair#*,}/topology/thread_siblings_list)`"
+      busy="$busy `expand_list $(l2_cpus ${pair%,*})` `expand_list $(l2_cpus ${pair#*,})`"
+      for c in $CPUS; do
+        if ! in_list $c "$busy" && [ "`core_type $c`" = "`core_type ${pair#*,}`" ]; then shared=$c; break; fi
+      done
+      if [ -z "$shared" ]; then
+        for c in $CPUS; do
+          if ! in_list $c "$busy"; then shared=$c; break; fi
+        done
+        [ -n "$shared" ] && echo "  $class/$state: no free `core_type ${pair#*,}`-core, using CPU $shared (`core_type $shared`-core) as BENCHIT_KERNEL_SHARED_CPU_LIST"
+      fi
+      if [ -z "$shared" ]; then echo "  $class/$state: no CPU available for BENCHIT_KERNEL_SHARED_CPU_LIST, skipped"; continue; fi
+    fi
+    echo "  $class/$state: CPU_LIST=\"$pair\" USE_MODE=\"$state\"${shared:+ SHARED_CPU_LIST=\"$shared\"}"
+    [ $DRY_RUN -eq 1 ] && continue
+
+    params=`mktemp /tmp/PARAMETERS.$class.$state.XXXXXX`
+    sed -e "s/^COMMENT=.*/COMMENT=\"$class\"/" \
+        -e "s/^BENCHIT_KERNEL_CPU_LIST=.*/BENCHIT_KERNEL_CPU_LIST=\"$pair\"/" \
+        -e "s/^BENCHIT_KERNEL_USE_MODE=.*/BENCHIT_KERNEL_USE_MODE=\"$state\"/" \
+        -e "${shared:+s/^BENCHIT_KERNEL_SHARED_CPU_LIST=.*/BENCHIT_KERNEL_SHARED_CPU_LIST=\"$shared\"/}" \
+        "$TEMPLATE" > $params
+    ./RUN.SH --parameter-file=$params $KERNEL
+    rm -f $params
+  done
+done